@@ -0,0 +1,242 @@
+// Layout benchmarks for clay. Runs a set of synthetic scenarios for a number of frames and prints the results as JSON.
+// Usage: clay_bench [frameCount] [scenarioName]
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define BENCH_WARMUP_FRAMES 10
+#define BENCH_MAX_ELEMENT_COUNT 131072
+
+typedef struct {
+    int32_t commitCount;
+    size_t committedBytes;
+} Bench_AllocationCounter;
+
+typedef struct {
+    const char *name;
+    void (*declareLayout)(int32_t frame);
+} Bench_Scenario;
+
+uint64_t Bench_GetTimeNanoseconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+#endif
+}
+
+// Deterministic text measurement - every character is half as wide as the font size
+Clay_Dimensions Bench_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.5f, .height = (float)config->fontSize };
+}
+
+// The whole arena is allocated up front, clay's requests to commit more of it are counted as allocations
+bool Bench_CountCommit(void *memory, size_t size, void *userData) {
+    Bench_AllocationCounter *counter = (Bench_AllocationCounter *)userData;
+    counter->commitCount++;
+    counter->committedBytes += size;
+    return true;
+}
+
+void Bench_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+}
+
+// Scenarios ----------------------------------
+
+void Bench_DeepNesting(int32_t frame) {
+    const int32_t depth = 10000;
+    for (int32_t i = 0; i < depth; ++i) {
+        Clay__OpenElement();
+        Clay__ConfigureOpenElement((Clay_ElementDeclaration) {
+            .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIT(0) }, .padding = { 1, 1, 1, 1 } },
+            .backgroundColor = { (float)(i % 255), 0, 0, 255 },
+        });
+    }
+    CLAY_TEXT(CLAY_STRING("Innermost"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+    for (int32_t i = 0; i < depth; ++i) {
+        Clay__CloseElement();
+    }
+}
+
+void Bench_WideRows(int32_t frame) {
+    const int32_t siblingCount = 10000;
+    CLAY(CLAY_ID("Rows"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        // Children grow to fill the row, up to differing maximums
+        CLAY(CLAY_ID("GrowRow"), { .layout = { .sizing = { CLAY_SIZING_FIXED(16000 + (float)(frame % 8)), CLAY_SIZING_FIXED(20) } } }) {
+            for (int32_t i = 0; i < siblingCount; ++i) {
+                CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0, 1 + (float)(i % 3)), CLAY_SIZING_GROW(0) } }, .backgroundColor = { 0, 0, 255, 255 } }) {}
+            }
+        }
+        // Children are larger than the row and have to shrink
+        CLAY(CLAY_ID("ShrinkRow"), { .layout = { .sizing = { CLAY_SIZING_FIXED(8000 + (float)(frame % 8)), CLAY_SIZING_FIXED(20) } } }) {
+            for (int32_t i = 0; i < siblingCount; ++i) {
+                CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_FIT(0.5f + (float)(i % 2)), CLAY_SIZING_GROW(0) }, .padding = { 1, 1, 0, 0 } }, .backgroundColor = { 0, 255, 0, 255 } }) {}
+            }
+        }
+    }
+}
+
+void Bench_TextParagraphs(int32_t frame) {
+    Clay_String paragraphs[] = {
+        CLAY_STRING("Clay is a flex-box style UI auto layout library in C, with declarative syntax and microsecond performance. It has a small memory footprint and no dependencies, and renders with any renderer that can draw rectangles, text and images."),
+        CLAY_STRING("Text wraps on whitespace and newlines, and measured words are cached between frames so that only new strings have to be passed to the measurement function. Long paragraphs like this one exercise the text wrapping phase of layout."),
+        CLAY_STRING("Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\nUt enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat."),
+    };
+    CLAY(CLAY_ID("Paragraphs"), { .layout = { .sizing = { CLAY_SIZING_FIXED(600 + (float)(frame % 16)), CLAY_SIZING_FIT(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM, .childGap = 8 } }) {
+        for (int32_t i = 0; i < 300; ++i) {
+            CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0) }, .padding = CLAY_PADDING_ALL(4) } }) {
+                CLAY_TEXT(paragraphs[i % 3], CLAY_TEXT_CONFIG({ .fontSize = (uint16_t)(14 + i % 4), .lineHeight = 20 }));
+            }
+        }
+    }
+}
+
+void Bench_FloatingRoots(int32_t frame) {
+    CLAY(CLAY_ID("FloatingParent"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } } }) {
+        for (int32_t i = 0; i < 1000; ++i) {
+            CLAY(CLAY_IDI("Floating", i), {
+                .layout = { .sizing = { CLAY_SIZING_FIXED(40), CLAY_SIZING_FIXED(20) }, .padding = CLAY_PADDING_ALL(2) },
+                .backgroundColor = { 255, 0, 0, 255 },
+                .floating = { .attachTo = CLAY_ATTACH_TO_PARENT, .offset = { (float)((i * 37 + frame) % 1000), (float)((i * 13) % 700) }, .zIndex = (int16_t)(i % 16) },
+            }) {
+                CLAY_TEXT(CLAY_STRING("Tip"), CLAY_TEXT_CONFIG({ .fontSize = 12 }));
+            }
+        }
+    }
+}
+
+void Bench_ScrollContainers(int32_t frame) {
+    CLAY(CLAY_ID("ScrollGrid"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .childGap = 4 } }) {
+        for (int32_t i = 0; i < 100; ++i) {
+            CLAY(CLAY_IDI("Scroll", i), {
+                .layout = { .sizing = { CLAY_SIZING_FIXED(10), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM },
+                .clip = { .vertical = true, .childOffset = Clay_GetScrollOffset() },
+            }) {
+                for (int32_t j = 0; j < 50; ++j) {
+                    CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_FIXED(30) } }, .backgroundColor = { 0, 0, (float)(j * 5), 255 } }) {}
+                }
+            }
+        }
+    }
+}
+
+void Bench_Transitions(int32_t frame) {
+    CLAY(CLAY_ID("TransitionGrid"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        for (int32_t i = 0; i < 500; ++i) {
+            // Widths change periodically so that a portion of the transitions are always active
+            float width = 20 + (float)(((frame / 10) + i) % 4) * 10;
+            CLAY(CLAY_IDI("Transition", i), {
+                .layout = { .sizing = { CLAY_SIZING_FIXED(width), CLAY_SIZING_FIXED(1) } },
+                .backgroundColor = { (float)(i % 255), 128, 0, 255 },
+                .transition = { .handler = Clay_EaseOut, .duration = 0.25f, .properties = CLAY_TRANSITION_PROPERTY_WIDTH | CLAY_TRANSITION_PROPERTY_BACKGROUND_COLOR },
+            }) {}
+        }
+    }
+}
+
+Bench_Scenario scenarios[] = {
+    { "deep_nesting", Bench_DeepNesting },
+    { "wide_rows", Bench_WideRows },
+    { "text_paragraphs", Bench_TextParagraphs },
+    { "floating_roots", Bench_FloatingRoots },
+    { "scroll_containers", Bench_ScrollContainers },
+    { "transitions", Bench_Transitions },
+};
+
+// --------------------------------------------
+
+void Bench_RunFrame(Bench_Scenario *scenario, int32_t frame) {
+    Clay_SetPointerState((Clay_Vector2) { (float)(frame * 7 % 1280), (float)(frame * 3 % 720) }, false);
+    Clay_UpdateScrollContainers(false, (Clay_Vector2) { 0, -5 }, 1.0f / 60.0f);
+    Clay_BeginLayout();
+    scenario->declareLayout(frame);
+    Clay_EndLayout(1.0f / 60.0f);
+}
+
+int main(int argc, char **argv) {
+    int32_t frameCount = argc > 1 ? atoi(argv[1]) : 100;
+    const char *scenarioFilter = argc > 2 ? argv[2] : NULL;
+    if (frameCount <= 0) {
+        fprintf(stderr, "Usage: clay_bench [frameCount] [scenarioName]\n");
+        return 1;
+    }
+
+    Bench_AllocationCounter allocations = { 0 };
+    Clay_MemoryConfig memoryConfig = {
+        .maxScrollContainerCount = 256,
+        .maxTransitionCount = 1024,
+        .growth = { .maxElementCount = BENCH_MAX_ELEMENT_COUNT, .maxMeasureTextCacheWordCount = BENCH_MAX_ELEMENT_COUNT, .commitMemoryFunction = Bench_CountCommit, .userData = &allocations },
+    };
+    size_t arenaSize = Clay_PlanMemory(memoryConfig).arenaCapacityBytes;
+    void *arenaMemory = malloc(arenaSize);
+
+    printf("{\"benchmarks\":[");
+    int32_t scenarioCount = 0;
+    for (int32_t i = 0; i < (int32_t)(sizeof(scenarios) / sizeof(scenarios[0])); ++i) {
+        Bench_Scenario *scenario = &scenarios[i];
+        if (scenarioFilter && strcmp(scenarioFilter, scenario->name) != 0) {
+            continue;
+        }
+        // Each scenario starts from a fresh context, and commits made while initializing and warming up are counted too
+        allocations = (Bench_AllocationCounter) { 0 };
+        // Unset memory config sizes are taken from the current context, which would carry over growth from the previous scenario
+        Clay_SetCurrentContext(NULL);
+        Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(arenaSize, arenaMemory);
+        if (!Clay_InitializeWithMemoryConfig(arena, (Clay_Dimensions) { 1280, 720 }, (Clay_ErrorHandler) { Bench_HandleError }, memoryConfig)) {
+            fprintf(stderr, "Failed to initialize clay for %s\n", scenario->name);
+            return 1;
+        }
+        Clay_SetMeasureTextFunction(Bench_MeasureText, NULL);
+        for (int32_t frame = 0; frame < BENCH_WARMUP_FRAMES; ++frame) {
+            Bench_RunFrame(scenario, frame);
+        }
+
+        int32_t warmupCommitCount = allocations.commitCount;
+        uint64_t startTime = Bench_GetTimeNanoseconds();
+        for (int32_t frame = BENCH_WARMUP_FRAMES; frame < BENCH_WARMUP_FRAMES + frameCount; ++frame) {
+            Bench_RunFrame(scenario, frame);
+        }
+        uint64_t totalTime = Bench_GetTimeNanoseconds() - startTime;
+
+        Clay_FrameStats frameStats = Clay_GetFrameStats();
+        Clay_MemoryStats memoryStats = Clay_GetMemoryStats();
+        double nsPerFrame = (double)totalTime / (double)frameCount;
+        printf("%s\n  {\"name\":\"%s\",\"frames\":%d,\"elements\":%d,\"renderCommands\":%d,\"nsPerFrame\":%.1f,\"nsPerElement\":%.3f,\"allocations\":%d,\"timedAllocations\":%d,\"allocatedBytes\":%zu,\"bytesUsed\":%zu,\"bytesCommitted\":%zu}",
+            scenarioCount > 0 ? "," : "",
+            scenario->name,
+            frameCount,
+            frameStats.elementCount,
+            frameStats.renderCommandCount,
+            nsPerFrame,
+            frameStats.elementCount > 0 ? nsPerFrame / (double)frameStats.elementCount : 0,
+            allocations.commitCount,
+            allocations.commitCount - warmupCommitCount,
+            allocations.committedBytes,
+            memoryStats.peakBytesUsed,
+            memoryStats.committedBytes);
+        scenarioCount++;
+    }
+    printf("\n]}\n");
+    free(arenaMemory);
+    return 0;
+}
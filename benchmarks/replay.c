@@ -0,0 +1,513 @@
+// Replays a recording made with Clay_SetRecorder() (see CLAY_RECORDING in clay.h) against this build of clay, without the original application.
+// Text measurement results are taken from the recording, so the layout is reproduced exactly.
+// Prints timing and a checksum of the generated render commands as JSON, which can be compared between builds to bisect layout changes.
+// Usage: clay_replay recording.bin [iterationCount] [--frames]
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define REPLAY_MAX_ELEMENT_COUNT 262144
+
+// Must match Clay__RecordEventType in clay.h
+typedef enum {
+    REPLAY_EVENT_LAYOUT_DIMENSIONS = 1,
+    REPLAY_EVENT_POINTER_STATE,
+    REPLAY_EVENT_UPDATE_SCROLL_CONTAINERS,
+    REPLAY_EVENT_BEGIN_LAYOUT,
+    REPLAY_EVENT_OPEN_ELEMENT,
+    REPLAY_EVENT_OPEN_ELEMENT_WITH_ID,
+    REPLAY_EVENT_CONFIGURE_ELEMENT,
+    REPLAY_EVENT_CLOSE_ELEMENT,
+    REPLAY_EVENT_TEXT_ELEMENT,
+    REPLAY_EVENT_END_LAYOUT,
+    REPLAY_EVENT_MEASURE_TEXT,
+} Replay_EventType;
+
+// Must match Clay__RecordConfigFlags in clay.h
+enum {
+    REPLAY_CONFIG_LAYOUT = 1 << 0,
+    REPLAY_CONFIG_BACKGROUND_COLOR = 1 << 1,
+    REPLAY_CONFIG_OVERLAY_COLOR = 1 << 2,
+    REPLAY_CONFIG_CORNER_RADIUS = 1 << 3,
+    REPLAY_CONFIG_ASPECT_RATIO = 1 << 4,
+    REPLAY_CONFIG_IMAGE = 1 << 5,
+    REPLAY_CONFIG_FLOATING = 1 << 6,
+    REPLAY_CONFIG_CUSTOM = 1 << 7,
+    REPLAY_CONFIG_CLIP = 1 << 8,
+    REPLAY_CONFIG_BORDER = 1 << 9,
+    REPLAY_CONFIG_TRANSITION = 1 << 10,
+};
+
+typedef struct {
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+    bool error;
+} Replay_Reader;
+
+typedef struct {
+    uint32_t hash;
+    Clay_String text;
+    uint16_t fontId;
+    uint16_t fontSize;
+    uint16_t letterSpacing;
+    uint16_t lineHeight;
+    Clay_Dimensions dimensions;
+} Replay_MeasuredText;
+
+typedef struct {
+    Replay_MeasuredText *entries;
+    uint32_t capacity;
+    int32_t missCount;
+} Replay_MeasureTextTable;
+
+// Passed as the image and custom data pointers of elements that had them set in the recording
+static int replayPlaceholderData;
+
+uint64_t Replay_GetTimeNanoseconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1000000000.0 / (double)frequency.QuadPart);
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+#endif
+}
+
+// Reading ---------------------------------------
+
+uint8_t Replay_ReadUInt8(Replay_Reader *reader) {
+    if (reader->position >= reader->length) {
+        reader->error = true;
+        return 0;
+    }
+    return reader->data[reader->position++];
+}
+
+uint32_t Replay_ReadVarUInt(Replay_Reader *reader) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = Replay_ReadUInt8(reader);
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    return value;
+}
+
+float Replay_ReadFloat(Replay_Reader *reader) {
+    union { float f; uint32_t u; } bits;
+    bits.u = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits.u |= (uint32_t)Replay_ReadUInt8(reader) << (i * 8);
+    }
+    return bits.f;
+}
+
+Clay_String Replay_ReadString(Replay_Reader *reader) {
+    uint32_t length = Replay_ReadVarUInt(reader);
+    if (length > reader->length - reader->position) {
+        reader->error = true;
+        return (Clay_String) { 0 };
+    }
+    Clay_String string = { .length = (int32_t)length, .chars = (const char *)reader->data + reader->position };
+    reader->position += length;
+    return string;
+}
+
+Clay_Color Replay_ReadColor(Replay_Reader *reader) {
+    Clay_Color color;
+    color.r = Replay_ReadFloat(reader);
+    color.g = Replay_ReadFloat(reader);
+    color.b = Replay_ReadFloat(reader);
+    color.a = Replay_ReadFloat(reader);
+    return color;
+}
+
+Clay_SizingAxis Replay_ReadSizingAxis(Replay_Reader *reader) {
+    Clay_SizingAxis axis = { 0 };
+    axis.type = (Clay__SizingType)Replay_ReadUInt8(reader);
+    if (axis.type == CLAY__SIZING_TYPE_PERCENT) {
+        axis.size.percent = Replay_ReadFloat(reader);
+    } else {
+        axis.size.minMax.min = Replay_ReadFloat(reader);
+        axis.size.minMax.max = Replay_ReadFloat(reader);
+    }
+    return axis;
+}
+
+Clay_TextElementConfig Replay_ReadTextConfig(Replay_Reader *reader) {
+    Clay_TextElementConfig config = { 0 };
+    config.textColor = Replay_ReadColor(reader);
+    config.fontId = (uint16_t)Replay_ReadVarUInt(reader);
+    config.fontSize = (uint16_t)Replay_ReadVarUInt(reader);
+    config.letterSpacing = (uint16_t)Replay_ReadVarUInt(reader);
+    config.lineHeight = (uint16_t)Replay_ReadVarUInt(reader);
+    config.wrapMode = (Clay_TextElementConfigWrapMode)Replay_ReadUInt8(reader);
+    config.textAlignment = (Clay_TextAlignment)Replay_ReadUInt8(reader);
+    return config;
+}
+
+Clay_TransitionData Replay_UnchangedTransitionState(Clay_TransitionData state, Clay_TransitionProperty properties) {
+    return state;
+}
+
+Clay_ElementDeclaration Replay_ReadDeclaration(Replay_Reader *reader) {
+    Clay_ElementDeclaration declaration = { 0 };
+    uint32_t flags = Replay_ReadVarUInt(reader);
+    if (flags & REPLAY_CONFIG_LAYOUT) {
+        Clay_LayoutConfig *layout = &declaration.layout;
+        layout->sizing.width = Replay_ReadSizingAxis(reader);
+        layout->sizing.height = Replay_ReadSizingAxis(reader);
+        layout->padding.left = (uint16_t)Replay_ReadVarUInt(reader);
+        layout->padding.right = (uint16_t)Replay_ReadVarUInt(reader);
+        layout->padding.top = (uint16_t)Replay_ReadVarUInt(reader);
+        layout->padding.bottom = (uint16_t)Replay_ReadVarUInt(reader);
+        layout->childGap = (uint16_t)Replay_ReadVarUInt(reader);
+        layout->childAlignment.x = (Clay_LayoutAlignmentX)Replay_ReadUInt8(reader);
+        layout->childAlignment.y = (Clay_LayoutAlignmentY)Replay_ReadUInt8(reader);
+        layout->layoutDirection = (Clay_LayoutDirection)Replay_ReadUInt8(reader);
+    }
+    if (flags & REPLAY_CONFIG_BACKGROUND_COLOR) declaration.backgroundColor = Replay_ReadColor(reader);
+    if (flags & REPLAY_CONFIG_OVERLAY_COLOR) declaration.overlayColor = Replay_ReadColor(reader);
+    if (flags & REPLAY_CONFIG_CORNER_RADIUS) {
+        declaration.cornerRadius.topLeft = Replay_ReadFloat(reader);
+        declaration.cornerRadius.topRight = Replay_ReadFloat(reader);
+        declaration.cornerRadius.bottomLeft = Replay_ReadFloat(reader);
+        declaration.cornerRadius.bottomRight = Replay_ReadFloat(reader);
+    }
+    if (flags & REPLAY_CONFIG_ASPECT_RATIO) declaration.aspectRatio.aspectRatio = Replay_ReadFloat(reader);
+    if (flags & REPLAY_CONFIG_IMAGE) declaration.image.imageData = &replayPlaceholderData;
+    if (flags & REPLAY_CONFIG_FLOATING) {
+        Clay_FloatingElementConfig *floating = &declaration.floating;
+        floating->offset.x = Replay_ReadFloat(reader);
+        floating->offset.y = Replay_ReadFloat(reader);
+        floating->expand.width = Replay_ReadFloat(reader);
+        floating->expand.height = Replay_ReadFloat(reader);
+        floating->parentId = Replay_ReadVarUInt(reader);
+        floating->zIndex = (int16_t)((int32_t)Replay_ReadVarUInt(reader) - 32768);
+        floating->attachPoints.element = (Clay_FloatingAttachPointType)Replay_ReadUInt8(reader);
+        floating->attachPoints.parent = (Clay_FloatingAttachPointType)Replay_ReadUInt8(reader);
+        floating->pointerCaptureMode = (Clay_PointerCaptureMode)Replay_ReadUInt8(reader);
+        floating->attachTo = (Clay_FloatingAttachToElement)Replay_ReadUInt8(reader);
+        floating->clipTo = (Clay_FloatingClipToElement)Replay_ReadUInt8(reader);
+    }
+    if (flags & REPLAY_CONFIG_CUSTOM) declaration.custom.customData = &replayPlaceholderData;
+    if (flags & REPLAY_CONFIG_CLIP) {
+        declaration.clip.horizontal = Replay_ReadUInt8(reader);
+        declaration.clip.vertical = Replay_ReadUInt8(reader);
+        declaration.clip.childOffset.x = Replay_ReadFloat(reader);
+        declaration.clip.childOffset.y = Replay_ReadFloat(reader);
+    }
+    if (flags & REPLAY_CONFIG_BORDER) {
+        declaration.border.color = Replay_ReadColor(reader);
+        declaration.border.width.left = (uint16_t)Replay_ReadVarUInt(reader);
+        declaration.border.width.right = (uint16_t)Replay_ReadVarUInt(reader);
+        declaration.border.width.top = (uint16_t)Replay_ReadVarUInt(reader);
+        declaration.border.width.bottom = (uint16_t)Replay_ReadVarUInt(reader);
+        declaration.border.width.betweenChildren = (uint16_t)Replay_ReadVarUInt(reader);
+    }
+    // The original callbacks aren't available, substitute the built in ease out and enter / exit transitions that leave the state unchanged
+    if (flags & REPLAY_CONFIG_TRANSITION) {
+        Clay_TransitionElementConfig *transition = &declaration.transition;
+        transition->handler = Clay_EaseOut;
+        transition->duration = Replay_ReadFloat(reader);
+        transition->properties = (Clay_TransitionProperty)Replay_ReadVarUInt(reader);
+        transition->interactionHandling = (Clay_TransitionInteractionHandlingType)Replay_ReadUInt8(reader);
+        transition->enter.setInitialState = Replay_ReadUInt8(reader) ? Replay_UnchangedTransitionState : NULL;
+        transition->enter.trigger = (Clay_TransitionEnterTriggerType)Replay_ReadUInt8(reader);
+        transition->exit.setFinalState = Replay_ReadUInt8(reader) ? Replay_UnchangedTransitionState : NULL;
+        transition->exit.trigger = (Clay_TransitionExitTriggerType)Replay_ReadUInt8(reader);
+        transition->exit.siblingOrdering = (Clay_ExitTransitionSiblingOrdering)Replay_ReadUInt8(reader);
+    }
+    return declaration;
+}
+
+// Text measurement ------------------------------
+
+uint32_t Replay_HashMeasuredText(const char *chars, int32_t length, Clay_TextElementConfig *config) {
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < length; ++i) {
+        hash = (hash ^ (uint8_t)chars[i]) * 16777619u;
+    }
+    uint16_t keys[] = { config->fontId, config->fontSize, config->letterSpacing, config->lineHeight };
+    for (int32_t i = 0; i < 4; ++i) {
+        hash = (hash ^ keys[i]) * 16777619u;
+    }
+    return hash;
+}
+
+Replay_MeasuredText *Replay_FindMeasuredText(Replay_MeasureTextTable *table, const char *chars, int32_t length, Clay_TextElementConfig *config, uint32_t hash) {
+    for (uint32_t i = hash & (table->capacity - 1);; i = (i + 1) & (table->capacity - 1)) {
+        Replay_MeasuredText *entry = &table->entries[i];
+        if (!entry->text.chars) {
+            return entry;
+        }
+        if (entry->hash == hash && entry->text.length == length && memcmp(entry->text.chars, chars, (size_t)length) == 0
+            && entry->fontId == config->fontId && entry->fontSize == config->fontSize && entry->letterSpacing == config->letterSpacing && entry->lineHeight == config->lineHeight) {
+            return entry;
+        }
+    }
+}
+
+Clay_Dimensions Replay_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    Replay_MeasureTextTable *table = (Replay_MeasureTextTable *)userData;
+    Replay_MeasuredText *entry = Replay_FindMeasuredText(table, text.chars, text.length, config, Replay_HashMeasuredText(text.chars, text.length, config));
+    if (!entry->text.chars) {
+        // Not measured in the original recording, e.g. text split differently by this build
+        table->missCount++;
+        return (Clay_Dimensions) { (float)text.length * (float)config->fontSize * 0.5f, (float)config->fontSize };
+    }
+    return entry->dimensions;
+}
+
+// Reads the payload of an event and applies it to the current context. When not applying, measure text results are added to the table instead.
+// Returns false if the recording is malformed.
+bool Replay_ReadEvent(Replay_Reader *reader, Replay_EventType type, Replay_MeasureTextTable *table, bool apply) {
+    switch (type) {
+        case REPLAY_EVENT_LAYOUT_DIMENSIONS: {
+            Clay_Dimensions dimensions;
+            dimensions.width = Replay_ReadFloat(reader);
+            dimensions.height = Replay_ReadFloat(reader);
+            if (apply) Clay_SetLayoutDimensions(dimensions);
+            break;
+        }
+        case REPLAY_EVENT_POINTER_STATE: {
+            Clay_Vector2 position;
+            position.x = Replay_ReadFloat(reader);
+            position.y = Replay_ReadFloat(reader);
+            bool isPointerDown = Replay_ReadUInt8(reader);
+            if (apply) Clay_SetPointerState(position, isPointerDown);
+            break;
+        }
+        case REPLAY_EVENT_UPDATE_SCROLL_CONTAINERS: {
+            bool enableDragScrolling = Replay_ReadUInt8(reader);
+            Clay_Vector2 scrollDelta;
+            scrollDelta.x = Replay_ReadFloat(reader);
+            scrollDelta.y = Replay_ReadFloat(reader);
+            float deltaTime = Replay_ReadFloat(reader);
+            if (apply) Clay_UpdateScrollContainers(enableDragScrolling, scrollDelta, deltaTime);
+            break;
+        }
+        case REPLAY_EVENT_BEGIN_LAYOUT: {
+            if (apply) Clay_BeginLayout();
+            break;
+        }
+        case REPLAY_EVENT_OPEN_ELEMENT: {
+            if (apply) Clay__OpenElement();
+            break;
+        }
+        case REPLAY_EVENT_OPEN_ELEMENT_WITH_ID: {
+            Clay_ElementId elementId;
+            elementId.id = Replay_ReadVarUInt(reader);
+            elementId.offset = Replay_ReadVarUInt(reader);
+            elementId.baseId = Replay_ReadVarUInt(reader);
+            elementId.stringId = Replay_ReadString(reader);
+            if (apply) Clay__OpenElementWithId(elementId);
+            break;
+        }
+        case REPLAY_EVENT_CONFIGURE_ELEMENT: {
+            Clay_ElementDeclaration declaration = Replay_ReadDeclaration(reader);
+            if (apply) Clay__ConfigureOpenElementPtr(&declaration);
+            break;
+        }
+        case REPLAY_EVENT_CLOSE_ELEMENT: {
+            if (apply) Clay__CloseElement();
+            break;
+        }
+        case REPLAY_EVENT_TEXT_ELEMENT: {
+            Clay_String text = Replay_ReadString(reader);
+            Clay_TextElementConfig config = Replay_ReadTextConfig(reader);
+            if (apply) Clay__OpenTextElement(text, config);
+            break;
+        }
+        case REPLAY_EVENT_END_LAYOUT: {
+            float deltaTime = Replay_ReadFloat(reader);
+            if (apply) Clay_EndLayout(deltaTime);
+            break;
+        }
+        case REPLAY_EVENT_MEASURE_TEXT: {
+            Clay_String text = Replay_ReadString(reader);
+            Clay_TextElementConfig config = Replay_ReadTextConfig(reader);
+            Clay_Dimensions dimensions;
+            dimensions.width = Replay_ReadFloat(reader);
+            dimensions.height = Replay_ReadFloat(reader);
+            if (!apply && table->entries) {
+                uint32_t hash = Replay_HashMeasuredText(text.chars, text.length, &config);
+                Replay_MeasuredText *entry = Replay_FindMeasuredText(table, text.chars, text.length, &config, hash);
+                *entry = (Replay_MeasuredText) { hash, text, config.fontId, config.fontSize, config.letterSpacing, config.lineHeight, dimensions };
+            } else if (!apply) {
+                table->capacity++;
+            }
+            break;
+        }
+        default: return false;
+    }
+    return !reader->error;
+}
+
+bool Replay_BuildMeasureTextTable(Replay_Reader reader, Replay_MeasureTextTable *table) {
+    // The first pass counts the measurements in table->capacity, the second pass inserts them
+    for (int pass = 0; pass < 2; ++pass) {
+        Replay_Reader passReader = reader;
+        while (passReader.position < passReader.length) {
+            if (!Replay_ReadEvent(&passReader, (Replay_EventType)Replay_ReadUInt8(&passReader), table, false)) {
+                return false;
+            }
+        }
+        if (pass == 0) {
+            uint32_t capacity = 16;
+            while (capacity < table->capacity * 2) capacity *= 2;
+            table->capacity = capacity;
+            table->entries = (Replay_MeasuredText *)calloc(capacity, sizeof(Replay_MeasuredText));
+        }
+    }
+    return true;
+}
+
+// --------------------------------------------
+
+uint64_t Replay_HashRenderCommands(Clay_RenderCommandArray commands) {
+    uint64_t hash = 14695981039346656037ull;
+    for (int32_t i = 0; i < commands.length; ++i) {
+        Clay_RenderCommand *command = &commands.internalArray[i];
+        uint32_t values[6];
+        values[0] = command->id;
+        values[1] = (uint32_t)command->commandType;
+        memcpy(&values[2], &command->boundingBox, sizeof(float) * 4);
+        for (int32_t j = 0; j < 6; ++j) {
+            hash = (hash ^ values[j]) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void Replay_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+}
+
+bool Replay_CommitMemory(void *memory, size_t size, void *userData) {
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: clay_replay recording.bin [iterationCount] [--frames]\n");
+        return 1;
+    }
+    int32_t iterationCount = 1;
+    bool printFrames = false;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--frames") == 0) {
+            printFrames = true;
+        } else {
+            iterationCount = atoi(argv[i]) > 0 ? atoi(argv[i]) : 1;
+        }
+    }
+
+    FILE *file = fopen(argv[1], "rb");
+    if (!file) {
+        fprintf(stderr, "Couldn't open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t *fileData = (uint8_t *)malloc((size_t)fileSize);
+    if (fileSize <= 0 || fread(fileData, 1, (size_t)fileSize, file) != (size_t)fileSize) {
+        fprintf(stderr, "Couldn't read %s\n", argv[1]);
+        return 1;
+    }
+    fclose(file);
+
+    if (fileSize < 8 || memcmp(fileData, "CLAYREC", 7) != 0 || fileData[7] != 1) {
+        fprintf(stderr, "%s is not a version 1 clay recording\n", argv[1]);
+        return 1;
+    }
+    Replay_Reader events = { fileData, (size_t)fileSize, 8, false };
+    Replay_MeasureTextTable measureTextTable = { 0 };
+    if (!Replay_BuildMeasureTextTable(events, &measureTextTable)) {
+        fprintf(stderr, "%s is truncated or corrupt\n", argv[1]);
+        return 1;
+    }
+
+    Clay_MemoryConfig memoryConfig = {
+        .maxScrollContainerCount = 1024,
+        .maxTransitionCount = 4096,
+        .growth = { .maxElementCount = REPLAY_MAX_ELEMENT_COUNT, .maxMeasureTextCacheWordCount = REPLAY_MAX_ELEMENT_COUNT, .commitMemoryFunction = Replay_CommitMemory },
+    };
+    size_t arenaSize = Clay_PlanMemory(memoryConfig).arenaCapacityBytes;
+    void *arenaMemory = malloc(arenaSize);
+
+    int32_t frameCount = 0;
+    int64_t elementCount = 0;
+    uint64_t totalTime = 0;
+    uint64_t checksum = 0;
+    // Recordings start with the layout dimensions at the time recording started. Initializing with them avoids
+    // replaying a resize, which would suppress transitions in the same way as a window resize
+    Clay_Dimensions initialDimensions = { 0, 0 };
+    Replay_Reader firstEvent = events;
+    if (Replay_ReadUInt8(&firstEvent) == REPLAY_EVENT_LAYOUT_DIMENSIONS) {
+        initialDimensions.width = Replay_ReadFloat(&firstEvent);
+        initialDimensions.height = Replay_ReadFloat(&firstEvent);
+    }
+
+    for (int32_t iteration = 0; iteration < iterationCount; ++iteration) {
+        // Each iteration starts from a fresh context so that results are identical
+        Clay_InitializeWithMemoryConfig(Clay_CreateArenaWithCapacityAndMemory(arenaSize, arenaMemory), initialDimensions, (Clay_ErrorHandler) { Replay_HandleError }, memoryConfig);
+        Clay_SetMeasureTextFunction(Replay_MeasureText, &measureTextTable);
+        Replay_Reader reader = events;
+        uint64_t frameStartTime = Replay_GetTimeNanoseconds();
+        checksum = 14695981039346656037ull;
+        int32_t iterationFrame = 0;
+        while (reader.position < reader.length) {
+            Replay_EventType type = (Replay_EventType)Replay_ReadUInt8(&reader);
+            Replay_ReadEvent(&reader, type, &measureTextTable, true);
+            if (type == REPLAY_EVENT_END_LAYOUT) {
+                uint64_t frameTime = Replay_GetTimeNanoseconds() - frameStartTime;
+                Clay_Context *context = Clay_GetCurrentContext();
+                uint64_t frameChecksum = Replay_HashRenderCommands(context->renderCommands);
+                checksum = (checksum ^ frameChecksum) * 1099511628211ull;
+                if (printFrames && iteration == 0) {
+                    fprintf(stderr, "frame %d: %d elements, %d render commands, %llu ns, checksum %016llx\n", iterationFrame, Clay_GetFrameStats().elementCount, context->renderCommands.length, (unsigned long long)frameTime, (unsigned long long)frameChecksum);
+                }
+                totalTime += frameTime;
+                elementCount += Clay_GetFrameStats().elementCount;
+                frameCount++;
+                iterationFrame++;
+                frameStartTime = Replay_GetTimeNanoseconds();
+            }
+        }
+    }
+
+    printf("{\"recording\":\"%s\",\"frames\":%d,\"iterations\":%d,\"nsPerFrame\":%.1f,\"nsPerElement\":%.3f,\"measureTextMisses\":%d,\"checksum\":\"%016llx\"}\n",
+        argv[1],
+        frameCount / iterationCount,
+        iterationCount,
+        frameCount > 0 ? (double)totalTime / (double)frameCount : 0,
+        elementCount > 0 ? (double)totalTime / (double)elementCount : 0,
+        measureTextTable.missCount / iterationCount,
+        (unsigned long long)checksum);
+    free(arenaMemory);
+    free(measureTextTable.entries);
+    free(fileData);
+    return 0;
+}
@@ -222,6 +222,273 @@ typedef struct Clay_Arena {
     char *memory;
 } Clay_Arena;
 
+// Clay_ArenaGrowthConfig allows clay's internal storage to grow past the element and measured word counts it was initialized with.
+// Address space for the maximum counts is reserved up front (see Clay_ReservedMemorySize()), and storage grows in place, so
+// data that is already in use is never relocated.
+typedef struct Clay_ArenaGrowthConfig {
+    // The largest number of elements that clay's internal storage can grow to.
+    int32_t maxElementCount;
+    // The largest number of measured words that clay's internal text measurement cache can grow to.
+    int32_t maxMeasureTextCacheWordCount;
+    // Called before clay first writes to a range of the reserved arena, e.g. to commit it with VirtualAlloc(MEM_COMMIT) or mprotect().
+    // Ranges are not page aligned and may overlap memory that was already committed. Return false if the memory could not be committed.
+    // Can be left NULL if the whole arena is already usable, e.g. when it was reserved with mmap and pages are committed on first touch.
+    bool (*commitMemoryFunction)(void *memory, size_t size, void *userData);
+    // A pointer that will be transparently passed through to commitMemoryFunction when it is called.
+    void *userData;
+} Clay_ArenaGrowthConfig;
+
+// Clay_MemoryConfig sizes each of clay's internal arrays independently, and is passed to Clay_InitializeWithMemoryConfig().
+// Any field left as 0 uses the same size as Clay_Initialize() would, which is derived from maxElementCount.
+typedef struct Clay_MemoryConfig {
+    // The maximum number of elements (including text elements) in a single layout.
+    // Sizes the layout element array as well as the per element buffers used while calculating layout.
+    int32_t maxElementCount;
+    // The maximum number of render commands generated by a single layout.
+    int32_t maxRenderCommandCount;
+    // The maximum number of lines that all text elements in a single layout can be wrapped into.
+    int32_t maxWrappedTextLineCount;
+    // The maximum number of floating elements in a single layout.
+    int32_t maxFloatingElementCount;
+    // The maximum number of element IDs that are retained between frames, used for Clay_GetElementData(), hover state, etc.
+    int32_t maxElementIdCount;
+    // The maximum number of distinct strings stored in the text measurement cache.
+    int32_t maxMeasureTextCacheEntryCount;
+    // The maximum number of measured "words" (whitespace seperated runs of characters) stored in the text measurement cache.
+    int32_t maxMeasureTextCacheWordCount;
+    // The maximum number of element IDs returned by Clay_GetPointerOverIds().
+    int32_t maxPointerOverIdCount;
+    // The maximum number of scroll containers. Defaults to 100.
+    int32_t maxScrollContainerCount;
+    // The maximum number of elements with transitions. Defaults to 200.
+    int32_t maxTransitionCount;
+    // The maximum number of warnings displayed by the debug view. Defaults to 100.
+    int32_t maxWarningCount;
+    // The number of bytes available for strings generated by the debug view.
+    int32_t debugStringDataSize;
+    // Allows storage to grow past the sizes above, see Clay_InitializeGrowable(). Sizes keep their ratio to maxElementCount as they grow.
+    Clay_ArenaGrowthConfig growth;
+} Clay_MemoryConfig;
+
+// Identifies one of clay's internal arrays in a Clay_MemoryPlan.
+typedef CLAY_PACKED_ENUM {
+    CLAY_MEMORY_ARRAY_LAYOUT_ELEMENTS,
+    CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN,
+    CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER,
+    CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_ID_STRINGS,
+    CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CLIP_ELEMENT_IDS,
+    CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK,
+    CLAY_MEMORY_ARRAY_OPEN_CLIP_ELEMENT_STACK,
+    CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER,
+    CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODES,
+    CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODE_VISITED,
+    CLAY_MEMORY_ARRAY_LAYOUT_TREE_ROOTS,
+    CLAY_MEMORY_ARRAY_RENDER_COMMANDS,
+    CLAY_MEMORY_ARRAY_WRAPPED_TEXT_LINES,
+    CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_ITEMS,
+    CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_BUCKETS,
+    CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_FREE_LIST,
+    CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_ITEMS,
+    CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_FREE_LIST,
+    CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_BUCKETS,
+    CLAY_MEMORY_ARRAY_MEASURED_WORDS,
+    CLAY_MEMORY_ARRAY_MEASURED_WORDS_FREE_LIST,
+    CLAY_MEMORY_ARRAY_POINTER_OVER_IDS,
+    CLAY_MEMORY_ARRAY_SCROLL_CONTAINERS,
+    CLAY_MEMORY_ARRAY_SCROLL_CONTAINER_BUCKETS,
+    CLAY_MEMORY_ARRAY_TRANSITIONS,
+    CLAY_MEMORY_ARRAY_TRANSITION_BUCKETS,
+    CLAY_MEMORY_ARRAY_WARNINGS,
+    CLAY_MEMORY_ARRAY_DEBUG_STRING_DATA,
+    CLAY_MEMORY_ARRAY_CACHED_SIZES,
+    CLAY_MEMORY_ARRAY_LAYOUT_TREE_ROOTS_BUFFER,
+    CLAY_MEMORY_ARRAY_DISTRIBUTION_KEYS,
+    CLAY_MEMORY_ARRAY_COUNT
+} Clay_MemoryArrayType;
+
+// The memory used by a single internal array, as reported by Clay_PlanMemory().
+typedef struct Clay_MemoryArrayPlan {
+    // The name of the array inside Clay_Context, e.g. "layoutElements".
+    Clay_String name;
+    // The number of items the array can initially hold.
+    int32_t capacity;
+    // The size in bytes of a single item.
+    int32_t itemSize;
+    // The number of bytes used by the array at its initial capacity.
+    size_t bytes;
+    // The number of bytes of address space reserved for the array, which is larger than bytes when growth is enabled.
+    size_t reservedBytes;
+} Clay_MemoryArrayPlan;
+
+// A breakdown of the memory required by a Clay_MemoryConfig, returned by Clay_PlanMemory().
+typedef struct Clay_MemoryPlan {
+    // One entry for each internal array, indexed by Clay_MemoryArrayType.
+    Clay_MemoryArrayPlan arrays[CLAY_MEMORY_ARRAY_COUNT];
+    // The size in bytes of the Clay_Context struct, which is stored at the start of the arena.
+    size_t contextBytes;
+    // The capacity in bytes that the arena passed to Clay_InitializeWithMemoryConfig() needs, including alignment padding.
+    size_t arenaCapacityBytes;
+    // The number of bytes that are committed up front, which is smaller than arenaCapacityBytes when growth is enabled.
+    size_t committedBytes;
+} Clay_MemoryPlan;
+
+// Usage of a single internal array, as reported by Clay_GetMemoryStats().
+typedef struct Clay_MemoryArrayStats {
+    // The name of the array inside Clay_Context, e.g. "layoutElements".
+    Clay_String name;
+    // The number of items in use at the end of the most recent layout. Scratch arrays are emptied again before then, so for
+    // those it is the most items they held since the end of the layout before it.
+    int32_t length;
+    // The highest length sampled by any layout since initialization or the last call to Clay_ResetMemoryStats().
+    int32_t peakLength;
+    // The number of items the array can currently hold.
+    int32_t capacity;
+    // The size in bytes of a single item.
+    int32_t itemSize;
+} Clay_MemoryArrayStats;
+
+// Occupancy of one of clay's internal hash maps, as reported by Clay_GetMemoryStats().
+typedef struct Clay_HashMapStats {
+    // The number of items currently stored in the hash map.
+    int32_t itemCount;
+    // The number of buckets in the hash map.
+    int32_t bucketCount;
+    // The number of buckets that contain at least one item.
+    int32_t usedBucketCount;
+    // itemCount / bucketCount
+    float loadFactor;
+    // The average number of items in each used bucket.
+    float averageChainLength;
+    // The number of items in the fullest bucket.
+    int32_t maxChainLength;
+} Clay_HashMapStats;
+
+// A snapshot of clay's internal memory usage, returned by Clay_GetMemoryStats().
+typedef struct Clay_MemoryStats {
+    // One entry for each internal array, indexed by Clay_MemoryArrayType.
+    // Note: arrays that are only used as scratch space during layout calculation (e.g. treeNodeVisited) always need to hold maxElementCount items.
+    Clay_MemoryArrayStats arrays[CLAY_MEMORY_ARRAY_COUNT];
+    // The map from element IDs to layout elements that is retained between frames.
+    Clay_HashMapStats elementHashMap;
+    // The map from text contents and config to measured words.
+    Clay_HashMapStats measureTextHashMap;
+    // The number of bytes of the arena that are allocated, including memory reserved for growth.
+    size_t arenaBytesUsed;
+    // The number of bytes of the arena that internal arrays can currently use.
+    size_t committedBytes;
+    // The number of bytes used by the Clay_Context struct and by every internal array at its peak length. Arrays can peak
+    // in different layouts, so this is an upper bound on the bytes in use at any one time.
+    size_t peakBytesUsed;
+    // The capacity in bytes of the arena passed to Clay_Initialize().
+    size_t arenaCapacityBytes;
+} Clay_MemoryStats;
+
+// The phases of layout calculation that are timed and reported by Clay_GetFrameStats().
+typedef CLAY_PACKED_ENUM {
+    // From Clay_BeginLayout() until the start of Clay_EndLayout(), i.e. the time spent declaring elements.
+    CLAY_LAYOUT_PHASE_DECLARATION,
+    // Cloning the subtrees of elements with exit transitions back into the layout.
+    CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING,
+    // Calculating widths of elements along the X axis.
+    CLAY_LAYOUT_PHASE_SIZE_X,
+    // Wrapping text elements into lines.
+    CLAY_LAYOUT_PHASE_TEXT_WRAPPING,
+    // Propagating the heights of wrapped text and aspect ratio elements up to their parents.
+    CLAY_LAYOUT_PHASE_PROPAGATE_HEIGHTS,
+    // Calculating heights of elements along the Y axis.
+    CLAY_LAYOUT_PHASE_SIZE_Y,
+    // Calculating final positions and generating render commands.
+    CLAY_LAYOUT_PHASE_FINAL_LAYOUT,
+    // Evaluating transitions and calling transition handlers.
+    CLAY_LAYOUT_PHASE_TRANSITIONS,
+    // Removing elements that weren't declared this frame from the element hash map.
+    CLAY_LAYOUT_PHASE_HASH_MAP_PRUNING,
+    // Testing the pointer position against elements in Clay_SetPointerState().
+    CLAY_LAYOUT_PHASE_POINTER_HIT_TESTING,
+    CLAY_LAYOUT_PHASE_COUNT,
+} Clay_LayoutPhase;
+
+// Optional callbacks used to time the phases of layout calculation, set with Clay_SetInstrumentationHooks().
+typedef struct Clay_InstrumentationHooks {
+    // Returns the current time in any monotonic unit, e.g. nanoseconds or CPU ticks. Used to fill out the phase times in Clay_FrameStats.
+    uint64_t (*timeFunction)(void *userData);
+    // Called when clay begins the given layout phase. Phases may be entered more than once per frame.
+    void (*phaseBeginFunction)(Clay_LayoutPhase phase, void *userData);
+    // Called when clay finishes the given layout phase.
+    void (*phaseEndFunction)(Clay_LayoutPhase phase, void *userData);
+    // A user data pointer that will be transparently passed through to the callbacks.
+    void *userData;
+} Clay_InstrumentationHooks;
+
+// Counters and phase timings for a single frame, returned by Clay_GetFrameStats().
+typedef struct Clay_FrameStats {
+    // Time spent in each layout phase, indexed by Clay_LayoutPhase, in the units returned by Clay_InstrumentationHooks.timeFunction.
+    // Phases that run more than once per frame (e.g. when transitions are active) are summed.
+    uint64_t phaseTimes[CLAY_LAYOUT_PHASE_COUNT];
+    // Time from the start of Clay_BeginLayout() to the end of Clay_EndLayout().
+    uint64_t totalTime;
+    // The number of layout elements, including text elements and cloned exiting elements.
+    int32_t elementCount;
+    // The number of text elements declared.
+    int32_t textElementCount;
+    // The number of render commands generated.
+    int32_t renderCommandCount;
+    // The number of times the function passed to Clay_SetMeasureTextFunction() was called.
+    int32_t measureTextCallCount;
+    // The number of measure text cache lookups that found an existing measurement. Text elements are looked up once when declared and again when wrapped.
+    int32_t measureTextCacheHitCount;
+    // The number of measure text cache lookups that had to measure the text.
+    int32_t measureTextCacheMissCount;
+    // True if nothing that affects the size of any element changed since the previous frame (e.g. only scroll offsets or colors changed),
+    // so the sizing and text wrapping phases were skipped and the previous frame's sizes were reused.
+    bool sizesReused;
+} Clay_FrameStats;
+
+// The number of recent frames kept by the flight recorder, see Clay_GetFlightRecorderFrames().
+#ifndef CLAY_FLIGHT_RECORDER_FRAME_COUNT
+#define CLAY_FLIGHT_RECORDER_FRAME_COUNT 64
+#endif
+
+// Capacity errors that occurred during a frame, stored in Clay_FlightRecorderFrame.capacityErrors.
+typedef enum {
+    CLAY_CAPACITY_ERROR_ELEMENTS = 1 << 0,
+    CLAY_CAPACITY_ERROR_RENDER_COMMANDS = 1 << 1,
+    CLAY_CAPACITY_ERROR_MEASURE_TEXT_CACHE = 1 << 2,
+    CLAY_CAPACITY_ERROR_HASH_MAP = 1 << 3,
+    CLAY_CAPACITY_ERROR_TEXT_MEASUREMENT_FUNCTION_NOT_SET = 1 << 4,
+} Clay_CapacityErrorFlags;
+
+// A compact summary of a single frame, kept by the flight recorder for the last CLAY_FLIGHT_RECORDER_FRAME_COUNT frames.
+typedef struct Clay_FlightRecorderFrame {
+    // Incremented by each call to Clay_BeginLayout().
+    uint32_t frameIndex;
+    // The deltaTime passed to Clay_EndLayout().
+    float deltaTime;
+    // Time spent in each layout phase in the units returned by Clay_InstrumentationHooks.timeFunction, truncated to 32 bits.
+    uint32_t phaseTimes[CLAY_LAYOUT_PHASE_COUNT];
+    // Time from the start of Clay_BeginLayout() to the end of Clay_EndLayout(), truncated to 32 bits.
+    uint32_t totalTime;
+    int32_t elementCount;
+    int32_t renderCommandCount;
+    int32_t measureTextCacheMissCount;
+    // The number of warnings stored for the debug view.
+    int32_t warningCount;
+    // A combination of Clay_CapacityErrorFlags for errors that occurred during the frame.
+    uint32_t capacityErrors;
+} Clay_FlightRecorderFrame;
+
+#ifdef CLAY_RECORDING
+// Receives a compact binary recording of everything that affects layout: layout dimensions, pointer and scroll input,
+// element declarations, text contents, deltaTime and the results of text measurement.
+// The recording can be replayed without the original application using the clay_replay tool in benchmarks/.
+typedef struct Clay_Recorder {
+    // Called with each chunk of recorded data, e.g. to append it to a file. Data is buffered and written at least once per frame.
+    void (*writeFunction)(const void *data, size_t length, void *userData);
+    // A user data pointer that will be transparently passed through to writeFunction.
+    void *userData;
+} Clay_Recorder;
+#endif
+
 typedef struct Clay_Dimensions {
     float width, height;
 } Clay_Dimensions;
@@ -231,6 +498,17 @@ typedef struct Clay_Vector2 {
 } Clay_Vector2;
 
 // Internally clay conventionally represents colors as 0-255, but interpretation is up to the renderer.
+#ifdef CLAY_COMPACT
+// CLAY_COMPACT stores colors as packed 8 bit channels and bounding boxes as whole numbers, for memory constrained targets that
+// render to integer pixels or cells anyway. Channels still range from 0 to 255, so colors are declared the same way in both profiles.
+typedef struct Clay_Color {
+    uint8_t r, g, b, a;
+} Clay_Color;
+
+typedef struct Clay_BoundingBox {
+    int16_t x, y, width, height;
+} Clay_BoundingBox;
+#else
 typedef struct Clay_Color {
     float r, g, b, a;
 } Clay_Color;
@@ -238,6 +516,7 @@ typedef struct Clay_Color {
 typedef struct Clay_BoundingBox {
     float x, y, width, height;
 } Clay_BoundingBox;
+#endif
 
 // Primarily created via the CLAY_ID(), CLAY_IDI(), CLAY_ID_LOCAL() and CLAY_IDI_LOCAL() macros.
 // Represents a hashed string ID used for identifying and finding specific clay UI elements, required
@@ -805,6 +1084,14 @@ typedef struct Clay_RenderCommand {
     // CLAY_RENDER_COMMAND_TYPE_SCISSOR_END - The renderer should finish any previously active clipping, and begin rendering elements in full again.
     // CLAY_RENDER_COMMAND_TYPE_CUSTOM - The renderer should provide a custom implementation for handling this render command based on its .customData
     Clay_RenderCommandType commandType;
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    // The intersection of the layout area and every scissor region that this command is drawn inside of.
+    // Only present when CLAY_RESOLVED_CLIP_RECTS is defined, in which case SCISSOR_START and SCISSOR_END commands aren't generated.
+    Clay_BoundingBox clipRect;
+    // The combination of every color overlay that this command is drawn inside of, equivalent to applying each of them in turn, or { 0 } if there are none.
+    // Only present when CLAY_RESOLVED_CLIP_RECTS is defined, in which case OVERLAY_COLOR_START and OVERLAY_COLOR_END commands aren't generated.
+    Clay_Color overlayColor;
+    #endif
 } Clay_RenderCommand;
 
 // A sized array of render commands.
@@ -817,6 +1104,79 @@ typedef struct Clay_RenderCommandArray {
     Clay_RenderCommand* internalArray;
 } Clay_RenderCommandArray;
 
+// Reads the records of a compact render command stream written by Clay_WriteCompactRenderCommands().
+// Initialize with the stream and its length, e.g. { buffer, length }, then call Clay_ReadCompactRenderCommand() until it returns false.
+typedef struct Clay_CompactRenderCommandReader {
+    // The encoded stream.
+    const uint8_t *data;
+    // The length of the encoded stream in bytes.
+    int32_t length;
+    // The offset in bytes of the next record to read.
+    int32_t offset;
+    // The zIndex of the previous record, as records only store their zIndex when it changes.
+    int16_t zIndex;
+} Clay_CompactRenderCommandReader;
+
+// A contiguous range of render commands that share a zIndex, see Clay_GetRenderLayers().
+typedef struct Clay_RenderLayer {
+    // The zIndex shared by every command in the layer.
+    int16_t zIndex;
+    // The index of the layer's first command in the render command array.
+    int32_t firstCommand;
+    // The number of commands in the layer.
+    int32_t commandCount;
+    // The union of the bounding boxes of the commands in the layer that draw something, i.e. excluding scissor and overlay commands.
+    Clay_BoundingBox boundingBox;
+    // A hash of every command in the layer, including the contents of text. If it matches the hash of the layer with the same zIndex
+    // last frame, the layer renders identically and a cached copy of it can be drawn instead.
+    // Image and custom data are only hashed by pointer, so changes to the data they point to aren't detected.
+    uint64_t hash;
+} Clay_RenderLayer;
+
+// A range of render commands that can be drawn with the same renderer state, see Clay_BatchRenderCommands().
+typedef struct Clay_RenderCommandBatch {
+    // The commandType of every command in the batch.
+    Clay_RenderCommandType commandType;
+    // The fontId of every command in the batch if commandType is CLAY_RENDER_COMMAND_TYPE_TEXT, otherwise 0.
+    uint16_t fontId;
+    // The imageData of every command in the batch if commandType is CLAY_RENDER_COMMAND_TYPE_IMAGE, otherwise NULL.
+    void *imageData;
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    // The clipRect and overlayColor shared by every command in the batch.
+    Clay_BoundingBox clipRect;
+    Clay_Color overlayColor;
+    #endif
+    // The index of the batch's first command in the output array.
+    int32_t firstCommand;
+    // The number of commands in the batch.
+    int32_t commandCount;
+    // The union of the bounding boxes of the commands in the batch.
+    Clay_BoundingBox boundingBox;
+} Clay_RenderCommandBatch;
+
+// Receives render commands while they are generated, instead of Clay_EndLayout() returning them all at once. Set with Clay_SetRenderCommandSink().
+typedef struct Clay_RenderCommandSink {
+    // Called with the next batch of render commands, in draw order. A batch is flushed after each layout root (the main layout or a floating
+    // element tree) is finished, whenever the internal render command array is full, and at the end of Clay_EndLayout().
+    // The commands are only valid until the function returns, and it must not call any other clay functions.
+    void (*flushFunction)(Clay_RenderCommandArray renderCommands, void *userData);
+    // A user data pointer that will be transparently passed through to flushFunction.
+    void *userData;
+} Clay_RenderCommandSink;
+
+// Caller provided memory that render commands are written into directly, set with Clay_SetRenderCommandBuffer().
+typedef struct Clay_RenderCommandBuffer {
+    // The memory that render commands are written into, e.g. a persistently mapped GPU buffer or memory shared with another process.
+    Clay_RenderCommand *memory;
+    // The number of render commands that fit in memory.
+    int32_t capacity;
+    // Optional, called when memory is full. Should return a buffer that holds the first length commands of memory and write its capacity, which must be
+    // larger than length, to *capacity. The returned buffer may be memory itself if it was extended in place. Return NULL to drop further commands this frame.
+    Clay_RenderCommand *(*growFunction)(Clay_RenderCommand *memory, int32_t length, int32_t *capacity, void *userData);
+    // A user data pointer that will be transparently passed through to growFunction.
+    void *userData;
+} Clay_RenderCommandBuffer;
+
 // Represents the current state of interaction with clay this frame.
 typedef CLAY_PACKED_ENUM {
     // A left mouse click, or touch occurred this frame.
@@ -946,6 +1306,50 @@ CLAY_DLL_EXPORT Clay_PointerData Clay_GetPointerState(void);
 // - layoutDimensions are the initial bounding dimensions of the layout (i.e. the screen width and height for a full screen layout)
 // - errorHandler is used by Clay to inform you if something has gone wrong in configuration or layout.
 CLAY_DLL_EXPORT Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler);
+// Returns the size, in bytes, of the address space that must be reserved for an arena that can grow up to the limits in growthConfig.
+// Only the memory required by Clay_MinMemorySize() is committed by Clay_InitializeGrowable(), the rest is committed on demand.
+CLAY_DLL_EXPORT size_t Clay_ReservedMemorySize(Clay_ArenaGrowthConfig growthConfig);
+// Initialize Clay with an arena that grows on demand instead of failing once the element count or text measurement cache is full.
+// - arena should have a capacity of at least Clay_ReservedMemorySize(growthConfig)
+// - growthConfig controls the maximum counts that storage can grow to, and how reserved memory is committed.
+// The initial counts are taken from Clay_SetMaxElementCount() and Clay_SetMaxMeasureTextCacheWordCount(), and are doubled each time they are exceeded.
+CLAY_DLL_EXPORT Clay_Context* Clay_InitializeGrowable(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler, Clay_ArenaGrowthConfig growthConfig);
+// Returns the capacity and size in bytes of each of clay's internal arrays for the given memory config, as well as the total arena size it requires.
+CLAY_DLL_EXPORT Clay_MemoryPlan Clay_PlanMemory(Clay_MemoryConfig memoryConfig);
+// Initialize Clay with each of its internal arrays sized according to memoryConfig.
+// - arena should have a capacity of at least Clay_PlanMemory(memoryConfig).arenaCapacityBytes
+CLAY_DLL_EXPORT Clay_Context* Clay_InitializeWithMemoryConfig(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler, Clay_MemoryConfig memoryConfig);
+// Returns the current and peak usage of each of clay's internal arrays, the occupancy of its hash maps and the number of arena bytes in use.
+// Lengths are sampled at the end of each call to Clay_EndLayout(). Intended for choosing memory config values, not for use every frame.
+CLAY_DLL_EXPORT Clay_MemoryStats Clay_GetMemoryStats(void);
+// Resets the peak lengths reported by Clay_GetMemoryStats() to the lengths at the end of the most recent layout.
+CLAY_DLL_EXPORT void Clay_ResetMemoryStats(void);
+// Sets the callbacks used to time each phase of layout calculation. Pass a zeroed struct to disable instrumentation.
+CLAY_DLL_EXPORT void Clay_SetInstrumentationHooks(Clay_InstrumentationHooks hooks);
+// Returns counters and phase timings for the most recently completed frame, i.e. the last call to Clay_SetPointerState() before Clay_BeginLayout() and the following Clay_BeginLayout() / Clay_EndLayout().
+// Phase times are only recorded if a time function was provided with Clay_SetInstrumentationHooks().
+CLAY_DLL_EXPORT Clay_FrameStats Clay_GetFrameStats(void);
+// Returns a human readable name for the layout phase, e.g. "SizeX".
+CLAY_DLL_EXPORT Clay_String Clay_GetLayoutPhaseName(Clay_LayoutPhase phase);
+// Copies the flight recorder's summaries of the most recent frames, oldest first, into frames and returns the number copied.
+// Doesn't allocate or call any user functions, so it is safe to call from crash or slow frame handlers.
+CLAY_DLL_EXPORT int32_t Clay_GetFlightRecorderFrames(Clay_FlightRecorderFrame *frames, int32_t maxFrameCount);
+#ifdef CLAY_TRACING
+// Returns the size in bytes of a trace buffer that can hold the last eventCount trace events.
+CLAY_DLL_EXPORT size_t Clay_TraceBufferSize(int32_t eventCount);
+// Sets the memory used as a ring buffer for trace events in the current context. Older events are overwritten once the buffer is full.
+// Pass NULL to stop tracing. Timestamps are taken from Clay_InstrumentationHooks.timeFunction, which should return nanoseconds.
+CLAY_DLL_EXPORT void Clay_SetTraceBuffer(void *memory, size_t size);
+// Writes the contents of the trace buffer to buffer as Chrome trace event JSON, which can be loaded by Perfetto or chrome://tracing.
+// Returns the total length of the JSON, which may be larger than bufferSize, in which case the output was truncated. The output is not null terminated.
+CLAY_DLL_EXPORT size_t Clay_WriteTraceJSON(char *buffer, size_t bufferSize);
+#endif
+#ifdef CLAY_RECORDING
+// Starts recording layout inputs for the current context, see Clay_Recorder. Pass a zeroed struct to stop recording.
+CLAY_DLL_EXPORT void Clay_SetRecorder(Clay_Recorder recorder);
+// Writes any recorded data that is still buffered to the recorder's write function.
+CLAY_DLL_EXPORT void Clay_FlushRecorder(void);
+#endif
 // Returns the Context that clay is currently using. Used when using multiple instances of clay simultaneously.
 CLAY_DLL_EXPORT Clay_Context* Clay_GetCurrentContext(void);
 // Sets the context that clay will use to compute the layout.
@@ -968,6 +1372,15 @@ CLAY_DLL_EXPORT void Clay_BeginLayout(void);
 // Called when all layout declarations are finished.
 // Computes the layout and generates and returns the array of render commands to draw.
 CLAY_DLL_EXPORT Clay_RenderCommandArray Clay_EndLayout(float deltaTime);
+// Returns true if the layout will keep changing without any new input, i.e. transitions are still running or scroll
+// containers still have momentum. Call after Clay_EndLayout() to decide whether to render again or wait for input.
+CLAY_DLL_EXPORT bool Clay_NeedsAnotherFrame(void);
+// Streams render commands to sink.flushFunction while Clay_EndLayout() runs, see Clay_RenderCommandSink. Clay_EndLayout() then returns an empty array,
+// and the number of render commands is no longer limited by the capacity of the render command array. Pass a zeroed struct to stop streaming.
+CLAY_DLL_EXPORT void Clay_SetRenderCommandSink(Clay_RenderCommandSink sink);
+// Writes render commands directly into buffer.memory instead of clay's own render command array, see Clay_RenderCommandBuffer.
+// The array returned by Clay_EndLayout() then points into buffer.memory. Pass a zeroed struct to go back to clay's own array.
+CLAY_DLL_EXPORT void Clay_SetRenderCommandBuffer(Clay_RenderCommandBuffer buffer);
 // Gets the ID of the currently open element, useful for retrieving IDs generated by CLAY_AUTO_ID()
 CLAY_DLL_EXPORT uint32_t Clay_GetOpenElementId(void);
 // Calculates a hash ID from the given idString.
@@ -1007,6 +1420,26 @@ CLAY_DLL_EXPORT void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFu
 CLAY_DLL_EXPORT void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData);
 // A bounds-checked "get" function for the Clay_RenderCommandArray returned from Clay_EndLayout().
 CLAY_DLL_EXPORT Clay_RenderCommand * Clay_RenderCommandArray_Get(Clay_RenderCommandArray* array, int32_t index);
+// Encodes renderCommands into buffer as a stream of variable length records, which is typically less than half the size of the
+// Clay_RenderCommand array. Intended for renderers and language bindings where copying render commands is expensive, e.g. across the WASM to JS boundary.
+// Pointers are written at native width, so the stream must be read in the same address space it was written in.
+// Returns the total length of the stream in bytes, which may be larger than bufferSize, in which case the output was truncated.
+CLAY_DLL_EXPORT int32_t Clay_WriteCompactRenderCommands(Clay_RenderCommandArray renderCommands, uint8_t *buffer, int32_t bufferSize);
+// Decodes the next record of a compact render command stream into renderCommand and advances the reader.
+// Returns false once the end of the stream is reached, or if the next record is truncated.
+CLAY_DLL_EXPORT bool Clay_ReadCompactRenderCommand(Clay_CompactRenderCommandReader *reader, Clay_RenderCommand *renderCommand);
+// Splits renderCommands into layers of consecutive commands with the same zIndex, copies up to maxLayerCount of them into layers and
+// returns the total number of layers. Commands are generated in ascending zIndex order, so each zIndex has at most one layer.
+CLAY_DLL_EXPORT int32_t Clay_GetRenderLayers(Clay_RenderCommandArray renderCommands, Clay_RenderLayer *layers, int32_t maxLayerCount);
+// Copies renderCommands into output, reordered so that commands which share a type, font or image are grouped together wherever that
+// doesn't change the rendered result, and writes the resulting ranges into batches. Commands are only moved past commands they don't
+// overlap, and never across scissor or overlay commands or between zIndex values. output must have room for renderCommands.length commands.
+// Returns the number of batches, or -1 if there were more than maxBatchCount, in which case output contains the commands in their original order.
+// A maxBatchCount of renderCommands.length is always enough.
+CLAY_DLL_EXPORT int32_t Clay_BatchRenderCommands(Clay_RenderCommandArray renderCommands, Clay_RenderCommand *output, Clay_RenderCommandBatch *batches, int32_t maxBatchCount);
+// Removes rectangle, border, text and image commands that are completely covered by an opaque rectangle drawn after them, i.e. one with an alpha
+// of 255 and no corner radius, taking scissor clipping into account. The remaining commands keep their order. Returns the number of commands removed.
+CLAY_DLL_EXPORT int32_t Clay_CullOccludedRenderCommands(Clay_RenderCommandArray *renderCommands);
 // Enables and disables Clay's internal debug tools.
 // This state is retained and does not need to be set each frame.
 CLAY_DLL_EXPORT void Clay_SetDebugModeEnabled(bool enabled);
@@ -1026,8 +1459,13 @@ CLAY_DLL_EXPORT int32_t Clay_GetMaxMeasureTextCacheWordCount(void);
 CLAY_DLL_EXPORT void Clay_SetMaxMeasureTextCacheWordCount(int32_t maxMeasureTextCacheWordCount);
 // Resets Clay's internal text measurement cache. Useful if font mappings have changed or fonts have been reloaded.
 CLAY_DLL_EXPORT void Clay_ResetMeasureTextCache(void);
-// A built in transition function that uses the "Ease Out" curve
+// A built in transition function that uses the "Ease Out" curve.
+// Transitions using one of the built in functions are evaluated together in batches, rather than through individual handler calls.
 CLAY_DLL_EXPORT bool Clay_EaseOut(Clay_TransitionCallbackArguments arguments);
+// A built in transition function that uses the "Ease In Out" curve, i.e. cubic-bezier(0.42, 0, 0.58, 1)
+CLAY_DLL_EXPORT bool Clay_EaseInOut(Clay_TransitionCallbackArguments arguments);
+// A built in transition function that follows a critically damped spring, settling exactly on the target at the end of the duration
+CLAY_DLL_EXPORT bool Clay_Spring(Clay_TransitionCallbackArguments arguments);
 
 // Internal API functions required by macros ----------------------
 
@@ -1063,6 +1501,39 @@ extern uint32_t Clay__debugViewWidth;
 #define CLAY__MAXFLOAT 3.40282346638528859812e+38F
 #endif
 
+#ifdef CLAY_COMPACT
+int16_t Clay__RoundCoordinate(float value) {
+    value = value < -32768.0f ? -32768.0f : (value > 32767.0f ? 32767.0f : value);
+    return (int16_t)(value >= 0 ? (int32_t)(value + 0.5f) : -(int32_t)(0.5f - value));
+}
+
+uint8_t Clay__RoundColorChannel(float value) {
+    value = value < 0 ? 0 : (value > 255.0f ? 255.0f : value);
+    return (uint8_t)(value + 0.5f);
+}
+#else
+#define Clay__RoundCoordinate(value) (value)
+#define Clay__RoundColorChannel(value) (value)
+#endif
+
+// Bounding boxes and colors that are calculated rather than declared are created with these, as CLAY_COMPACT rounds them to integers
+Clay_BoundingBox Clay__BoundingBox(float x, float y, float width, float height) {
+    #ifdef CLAY_COMPACT
+    // The edges are rounded rather than the size, so that adjacent elements stay adjacent
+    int16_t left = Clay__RoundCoordinate(x);
+    int16_t top = Clay__RoundCoordinate(y);
+    Clay_BoundingBox boundingBox = { left, top, Clay__RoundCoordinate((float)(Clay__RoundCoordinate(x + width) - left)), Clay__RoundCoordinate((float)(Clay__RoundCoordinate(y + height) - top)) };
+    #else
+    Clay_BoundingBox boundingBox = { x, y, width, height };
+    #endif
+    return boundingBox;
+}
+
+Clay_Color Clay__Color(float r, float g, float b, float a) {
+    Clay_Color color = { Clay__RoundColorChannel(r), Clay__RoundColorChannel(g), Clay__RoundColorChannel(b), Clay__RoundColorChannel(a) };
+    return color;
+}
+
 Clay_LayoutConfig CLAY_LAYOUT_DEFAULT = CLAY__DEFAULT_STRUCT;
 
 Clay_Color Clay__Color_DEFAULT = CLAY__DEFAULT_STRUCT;
@@ -1146,6 +1617,56 @@ typedef struct                                      \
                                                     \
 CLAY__ARRAY_DEFINE_FUNCTIONS(typeName, arrayName)   \
 
+// Defines functions to look up items of an array of per element state by element id. typeName must have an elementId and
+// a nextIndex field. Items are chained into buckets like the layout element hash map, and removed with swapback so the
+// array stays densely packed.
+#define CLAY__ELEMENT_DATA_MAP_DEFINE(typeName, arrayName)                                                      \
+                                                                                                                \
+typeName *arrayName##_Find(arrayName *array, Clay__int32_tArray *buckets, uint32_t elementId) {                 \
+    int32_t index = buckets->internalArray[elementId % buckets->capacity];                                      \
+    while (index != -1) {                                                                                       \
+        typeName *item = &array->internalArray[index];                                                          \
+        if (item->elementId == elementId) {                                                                     \
+            return item;                                                                                        \
+        }                                                                                                       \
+        index = item->nextIndex;                                                                                \
+    }                                                                                                           \
+    return CLAY__NULL;                                                                                          \
+}                                                                                                               \
+                                                                                                                \
+typeName *arrayName##_Insert(arrayName *array, Clay__int32_tArray *buckets, typeName item) {                    \
+    if (!Clay__Array_AddCapacityCheck(array->length, array->capacity)) {                                        \
+        return &typeName##_DEFAULT;                                                                             \
+    }                                                                                                           \
+    int32_t *bucket = &buckets->internalArray[item.elementId % buckets->capacity];                              \
+    item.nextIndex = *bucket;                                                                                   \
+    *bucket = array->length;                                                                                    \
+    array->internalArray[array->length++] = item;                                                               \
+    return &array->internalArray[array->length - 1];                                                            \
+}                                                                                                               \
+                                                                                                                \
+/* Returns the bucket or nextIndex that refers to the item at index */                                          \
+int32_t *arrayName##_FindLink(arrayName *array, Clay__int32_tArray *buckets, int32_t index) {                   \
+    int32_t *link = &buckets->internalArray[array->internalArray[index].elementId % buckets->capacity];         \
+    while (*link != index) {                                                                                    \
+        link = &array->internalArray[*link].nextIndex;                                                          \
+    }                                                                                                           \
+    return link;                                                                                                \
+}                                                                                                               \
+                                                                                                                \
+void arrayName##_Remove(arrayName *array, Clay__int32_tArray *buckets, int32_t index) {                         \
+    if (!Clay__Array_RangeCheck(index, array->length)) {                                                        \
+        return;                                                                                                 \
+    }                                                                                                           \
+    *arrayName##_FindLink(array, buckets, index) = array->internalArray[index].nextIndex;                       \
+    int32_t lastIndex = array->length - 1;                                                                      \
+    if (index != lastIndex) {                                                                                   \
+        *arrayName##_FindLink(array, buckets, lastIndex) = index;                                               \
+        array->internalArray[index] = array->internalArray[lastIndex];                                          \
+    }                                                                                                           \
+    array->length--;                                                                                            \
+}                                                                                                               \
+
 Clay_Context *Clay__currentContext;
 int32_t Clay__defaultMaxElementCount = 8192;
 int32_t Clay__defaultMaxMeasureTextWordCacheCount = 16384;
@@ -1186,6 +1707,7 @@ bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity);
 
 CLAY__ARRAY_DEFINE(bool, Clay__boolArray)
 CLAY__ARRAY_DEFINE(int32_t, Clay__int32_tArray)
+CLAY__ARRAY_DEFINE(uint32_t, Clay__uint32_tArray)
 CLAY__ARRAY_DEFINE(char, Clay__charArray)
 CLAY__ARRAY_DEFINE_FUNCTIONS(Clay_ElementId, Clay_ElementIdArray)
 CLAY__ARRAY_DEFINE(Clay_String, Clay__StringArray)
@@ -1230,6 +1752,17 @@ typedef struct Clay_LayoutElement {
 
 CLAY__ARRAY_DEFINE(Clay_LayoutElement, Clay_LayoutElementArray)
 
+// The sizing results of a single layout element, indexed the same way as layoutElements
+typedef struct {
+    Clay_Dimensions dimensions;
+    // Text elements only - wrapped lines are left in place in wrappedTextLines, and rebased if the text has moved
+    const char *textChars;
+    int32_t wrappedLinesIndex;
+    int32_t wrappedLinesLength;
+} Clay__CachedSize;
+
+CLAY__ARRAY_DEFINE(Clay__CachedSize, Clay__CachedSizeArray)
+
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_BoundingBox boundingBox;
@@ -1241,11 +1774,13 @@ typedef struct {
     Clay_Vector2 previousDelta;
     float momentumTime;
     uint32_t elementId;
+    int32_t nextIndex;
     bool openThisFrame;
     bool pointerScrollActive;
 } Clay__ScrollContainerDataInternal;
 
 CLAY__ARRAY_DEFINE(Clay__ScrollContainerDataInternal, Clay__ScrollContainerDataInternalArray)
+CLAY__ELEMENT_DATA_MAP_DEFINE(Clay__ScrollContainerDataInternal, Clay__ScrollContainerDataInternalArray)
 
 // Data representing the current internal state of a transition element.
 typedef struct Clay__TransitionDataInternal {
@@ -1255,16 +1790,19 @@ typedef struct Clay__TransitionDataInternal {
     Clay_LayoutElement* elementThisFrame;
     Clay_Vector2 oldParentRelativePosition;
     uint32_t elementId;
+    int32_t nextIndex;
     uint32_t parentId;
     uint32_t siblingIndex;
     float elapsedTime;
     Clay_TransitionState state;
     bool transitionOut;
     bool reparented;
+    bool evaluationPending;
     Clay_TransitionProperty activeProperties;
 } Clay__TransitionDataInternal;
 
 CLAY__ARRAY_DEFINE(Clay__TransitionDataInternal, Clay__TransitionDataInternalArray)
+CLAY__ELEMENT_DATA_MAP_DEFINE(Clay__TransitionDataInternal, Clay__TransitionDataInternalArray)
 
 typedef struct { // todo get this struct into a single cache line
     Clay_BoundingBox boundingBox;
@@ -1305,10 +1843,28 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__MeasureTextCacheItem, Clay__MeasureTextCacheItemArray)
 
+#ifdef CLAY_RESOLVED_CLIP_RECTS
+// The scissor region and color overlay that apply to the render commands currently being generated
+typedef struct {
+    Clay_BoundingBox clipRect;
+    Clay_Color overlayColor;
+} Clay__RenderState;
+
+#define CLAY__RESOLVE(statement) statement
+#else
+#define CLAY__RESOLVE(statement)
+#endif
+
 typedef struct {
     Clay_LayoutElement *layoutElement;
     Clay_Vector2 position;
     Clay_Vector2 nextChildOffset;
+    // The intersection of the window and every clip container above this element, used for culling
+    Clay_BoundingBox clipRect;
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    // The render state inside this element, i.e. after its own scissor and overlay have been applied
+    Clay__RenderState renderState;
+    #endif
     bool parentMovedThisFramed; // Used to relativise transitions
 } Clay__LayoutElementTreeNode;
 
@@ -1324,13 +1880,50 @@ typedef struct {
 
 CLAY__ARRAY_DEFINE(Clay__LayoutElementTreeRoot, Clay__LayoutElementTreeRootArray)
 
+#ifdef CLAY_RECORDING
+#define CLAY__RECORD_BUFFER_SIZE 4096
+#define CLAY__RECORD(call) call
+#else
+#define CLAY__RECORD(call)
+#endif
+
+#ifdef CLAY_TRACING
+typedef CLAY_PACKED_ENUM {
+    CLAY__TRACE_EVENT_TYPE_BEGIN,
+    CLAY__TRACE_EVENT_TYPE_END,
+    CLAY__TRACE_EVENT_TYPE_COUNTER,
+} Clay__TraceEventType;
+
+typedef struct Clay__TraceEvent {
+    uint64_t timestamp;
+    Clay_String name;
+    // If set, the event is written with an args object containing argName: value
+    Clay_String argName;
+    uint32_t value;
+    Clay__TraceEventType type;
+} Clay__TraceEvent;
+
+#define CLAY__TRACE(context, type, name, argName, value) Clay__RecordTraceEvent(context, type, name, argName, value)
+#else
+#define CLAY__TRACE(context, type, name, argName, value)
+#endif
+
 struct Clay_Context {
     int32_t maxElementCount;
     int32_t maxMeasureTextCacheWordCount;
     int32_t exitingElementsLength;
     int32_t exitingElementsChildrenLength;
+    // Subtrees of exiting elements are retained directly after the root container for the duration of their exit transition
+    int32_t retainedElementsLength;
+    int32_t retainedElementChildrenLength;
+    int32_t retainedSubtreeCount;
     bool warningsEnabled;
     bool rootResizedLastFrame;
+    // Hash of everything declared this frame that affects element sizes, see Clay__HashSizingInputs()
+    uint64_t sizingHash;
+    uint64_t previousSizingHash;
+    int32_t cachedWrappedTextLineCount;
+    bool sizeCacheValid;
     Clay_ErrorHandler errorHandler;
     Clay_BooleanWarnings booleanWarnings;
     Clay__WarningArray warnings;
@@ -1348,19 +1941,51 @@ struct Clay_Context {
     void *measureTextUserData;
     void *queryScrollOffsetUserData;
     Clay_Arena internalArena;
+    Clay_MemoryConfig memoryConfig;
+    int32_t memoryArrayLengths[CLAY_MEMORY_ARRAY_COUNT];
+    int32_t memoryArrayPeakLengths[CLAY_MEMORY_ARRAY_COUNT];
+    int32_t memoryArrayScratchLengths[CLAY_MEMORY_ARRAY_COUNT];
+    Clay_InstrumentationHooks instrumentationHooks;
+    Clay_FrameStats frameStats;
+    Clay_FrameStats lastFrameStats;
+    uint64_t declarationStartTime;
+    Clay_FlightRecorderFrame flightRecorderFrames[CLAY_FLIGHT_RECORDER_FRAME_COUNT];
+    uint32_t flightRecorderFrameCount;
+    #ifdef CLAY_TRACING
+    Clay__TraceEvent *traceEvents;
+    int32_t traceEventCapacity;
+    uint64_t traceEventCount;
+    #endif
+    #ifdef CLAY_RECORDING
+    Clay_Recorder recorder;
+    bool recordingHeaderWritten;
+    bool recordingDeclarations;
+    int32_t recordBufferLength;
+    uint8_t recordBuffer[CLAY__RECORD_BUFFER_SIZE];
+    #endif
     // Layout Elements / Render Commands
     Clay_LayoutElementArray layoutElements;
     Clay_RenderCommandArray renderCommands;
+    Clay_RenderCommandSink renderCommandSink;
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    Clay__RenderState renderState;
+    #endif
+    Clay_RenderCommandBuffer renderCommandBuffer;
+    // Points into renderCommandBuffer.memory while a caller provided buffer is set
+    Clay_RenderCommandArray bufferedRenderCommands;
+    int32_t flushedRenderCommandCount;
     Clay__int32_tArray openLayoutElementStack;
     Clay__int32_tArray layoutElementChildren;
     Clay__int32_tArray layoutElementChildrenBuffer;
     Clay__int32_tArray reusableElementIndexBuffer;
+    Clay__uint32_tArray distributionKeys;
     Clay__int32_tArray layoutElementClipElementIds;
     // Misc Data Structures
     Clay__StringArray layoutElementIdStrings;
     Clay__WrappedTextLineArray wrappedTextLines;
     Clay__LayoutElementTreeNodeArray layoutElementTreeNodeArray1;
     Clay__LayoutElementTreeRootArray layoutElementTreeRoots;
+    Clay__LayoutElementTreeRootArray layoutElementTreeRootsBuffer;
     Clay__LayoutElementHashMapItemArray layoutElementsHashMapInternal;
     Clay__int32_tArray layoutElementsHashMap;
     Clay__int32_tArray layoutElementsHashMapFreeList;
@@ -1372,7 +1997,10 @@ struct Clay_Context {
     Clay__int32_tArray openClipElementStack;
     Clay_ElementIdArray pointerOverIds;
     Clay__ScrollContainerDataInternalArray scrollContainerDatas;
+    Clay__int32_tArray scrollContainerDataBuckets;
     Clay__TransitionDataInternalArray transitionDatas;
+    Clay__int32_tArray transitionDataBuckets;
+    Clay__CachedSizeArray cachedSizes;
     Clay__boolArray treeNodeVisited;
     Clay__charArray dynamicStringData;
 };
@@ -1387,6 +2015,268 @@ Clay_Context* Clay__Context_Allocate_Arena(Clay_Arena *arena) {
     return (Clay_Context*)(arena->memory);
 }
 
+// Fills in any memory config fields left as 0 with the sizes used by Clay_Initialize()
+Clay_MemoryConfig Clay__ResolveMemoryConfig(Clay_MemoryConfig config) {
+    Clay_Context *currentContext = Clay_GetCurrentContext();
+    if (config.maxElementCount <= 0) config.maxElementCount = currentContext ? currentContext->maxElementCount : Clay__defaultMaxElementCount;
+    if (config.maxMeasureTextCacheWordCount <= 0) config.maxMeasureTextCacheWordCount = currentContext ? currentContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount;
+    if (config.maxRenderCommandCount <= 0) config.maxRenderCommandCount = config.maxElementCount;
+    if (config.maxWrappedTextLineCount <= 0) config.maxWrappedTextLineCount = config.maxElementCount;
+    if (config.maxFloatingElementCount <= 0) config.maxFloatingElementCount = config.maxElementCount - 1;
+    if (config.maxElementIdCount <= 0) config.maxElementIdCount = config.maxElementCount;
+    if (config.maxMeasureTextCacheEntryCount <= 0) config.maxMeasureTextCacheEntryCount = config.maxElementCount;
+    if (config.maxPointerOverIdCount <= 0) config.maxPointerOverIdCount = config.maxElementCount;
+    if (config.maxScrollContainerCount <= 0) config.maxScrollContainerCount = 100;
+    if (config.maxTransitionCount <= 0) config.maxTransitionCount = 200;
+    if (config.maxWarningCount <= 0) config.maxWarningCount = 100;
+    if (config.debugStringDataSize <= 0) config.debugStringDataSize = config.maxElementCount;
+    return config;
+}
+
+int32_t Clay__ReservedElementCount(Clay_Context *context) {
+    return CLAY__MAX(context->memoryConfig.growth.maxElementCount, context->maxElementCount);
+}
+
+int32_t Clay__ReservedMeasuredWordCount(Clay_Context *context) {
+    return CLAY__MAX(context->memoryConfig.growth.maxMeasureTextCacheWordCount, context->maxMeasureTextCacheWordCount);
+}
+
+// Scales a capacity from the memory config, which was sized for memoryConfig.maxElementCount, to the given element count
+int32_t Clay__ScaleCapacity(Clay_Context *context, int32_t capacity, int32_t elementCount) {
+    if (elementCount == context->memoryConfig.maxElementCount) {
+        return capacity;
+    }
+    return (int32_t)((int64_t)capacity * elementCount / context->memoryConfig.maxElementCount);
+}
+
+// layoutElements, layoutElementIdStrings, layoutElementClipElementIds and layoutElementChildren always keep their reserved capacity, because subtrees
+// with exit transitions are stored backwards from the end of them between frames (see Clay__CloneElementsWithExitTransition).
+void Clay__SetEphemeralElementCapacity(Clay_Context *context) {
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t elementCount = context->maxElementCount;
+    context->layoutElementChildrenBuffer.capacity = elementCount;
+    context->wrappedTextLines.capacity = Clay__ScaleCapacity(context, config->maxWrappedTextLineCount, elementCount);
+    context->layoutElementTreeNodeArray1.capacity = elementCount;
+    context->layoutElementTreeRoots.capacity = Clay__ScaleCapacity(context, config->maxFloatingElementCount + 1, elementCount);
+    context->layoutElementTreeRootsBuffer.capacity = context->layoutElementTreeRoots.capacity;
+    context->openLayoutElementStack.capacity = elementCount;
+    context->renderCommands.capacity = Clay__ScaleCapacity(context, config->maxRenderCommandCount, elementCount);
+    context->treeNodeVisited.capacity = elementCount;
+    context->treeNodeVisited.length = elementCount; // This array is accessed directly rather than behaving as a list
+    context->openClipElementStack.capacity = elementCount;
+    context->reusableElementIndexBuffer.capacity = elementCount;
+    context->distributionKeys.capacity = elementCount * 3;
+    context->dynamicStringData.capacity = Clay__ScaleCapacity(context, config->debugStringDataSize, elementCount);
+}
+
+void Clay__SetPersistentElementCapacity(Clay_Context *context) {
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t elementCount = context->maxElementCount;
+    context->layoutElementsHashMapInternal.capacity = Clay__ScaleCapacity(context, config->maxElementIdCount, elementCount);
+    context->layoutElementsHashMap.capacity = Clay__ScaleCapacity(context, config->maxElementIdCount, elementCount);
+    context->layoutElementsHashMapFreeList.capacity = Clay__ScaleCapacity(context, config->maxElementIdCount, elementCount);
+    context->measureTextHashMapInternal.capacity = Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, elementCount);
+    context->measureTextHashMapInternalFreeList.capacity = Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, elementCount);
+    context->pointerOverIds.capacity = Clay__ScaleCapacity(context, config->maxPointerOverIdCount, elementCount);
+    context->cachedSizes.capacity = elementCount;
+}
+
+bool Clay__CommitArenaMemory(Clay_Context *context, void *memory, size_t size) {
+    Clay_ArenaGrowthConfig *growth = &context->memoryConfig.growth;
+    if (!growth->commitMemoryFunction || size == 0 || growth->commitMemoryFunction(memory, size, growth->userData)) {
+        return true;
+    }
+    context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+        .errorType = CLAY_ERROR_TYPE_ARENA_CAPACITY_EXCEEDED,
+        .errorText = CLAY_STRING("Clay attempted to grow its internal storage, but the commitMemoryFunction passed to Clay_InitializeGrowable() failed to commit more memory."),
+        .userData = context->errorHandler.userData });
+    return false;
+}
+
+#define CLAY__COMMIT_ARRAY_RANGE(context, array, from, to) Clay__CommitArenaMemory(context, (array).internalArray + (from), (size_t)((to) - (from)) * sizeof(*(array).internalArray))
+#define CLAY__COMMIT_SCALED_ARRAY_RANGE(context, array, capacity, from, to) CLAY__COMMIT_ARRAY_RANGE(context, array, Clay__ScaleCapacity(context, capacity, from), Clay__ScaleCapacity(context, capacity, to))
+
+// Commits the items of every array that scales with the element count, between the capacities for element counts from and to.
+// Arrays that store exiting subtrees at their end also have the same number of items committed backwards from their reserved capacity.
+bool Clay__CommitElementStorage(Clay_Context *context, int32_t from, int32_t to) {
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t reserved = Clay__ReservedElementCount(context);
+    return CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementChildrenBuffer, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElements, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElements, reserved - to, reserved - from)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementIdStrings, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementIdStrings, reserved - to, reserved - from)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->wrappedTextLines, config->maxWrappedTextLineCount, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementTreeNodeArray1, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->layoutElementTreeRoots, config->maxFloatingElementCount + 1, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->layoutElementTreeRootsBuffer, config->maxFloatingElementCount + 1, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementChildren, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementChildren, reserved - to, reserved - from)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->openLayoutElementStack, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->renderCommands, config->maxRenderCommandCount, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->treeNodeVisited, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->openClipElementStack, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->reusableElementIndexBuffer, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->distributionKeys, from * 3, to * 3)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementClipElementIds, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->layoutElementClipElementIds, reserved - to, reserved - from)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->dynamicStringData, config->debugStringDataSize, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->layoutElementsHashMapInternal, config->maxElementIdCount, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->layoutElementsHashMap, config->maxElementIdCount, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->layoutElementsHashMapFreeList, config->maxElementIdCount, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->measureTextHashMapInternal, config->maxMeasureTextCacheEntryCount, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->measureTextHashMapInternalFreeList, config->maxMeasureTextCacheEntryCount, from, to)
+        && CLAY__COMMIT_SCALED_ARRAY_RANGE(context, context->pointerOverIds, config->maxPointerOverIdCount, from, to)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->cachedSizes, from, to);
+}
+
+// Rebuilds the element hash map's chains after its bucket count has changed.
+// Items stay at the same index in layoutElementsHashMapInternal, so pointers to them remain valid.
+void Clay__RehashElementHashMap(Clay_Context *context, int32_t previousBucketCount) {
+    int32_t chainHead = -1;
+    for (int32_t i = 0; i < previousBucketCount; ++i) {
+        int32_t itemIndex = context->layoutElementsHashMap.internalArray[i];
+        while (itemIndex != -1) {
+            Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, itemIndex);
+            int32_t nextIndex = hashItem->nextIndex;
+            hashItem->nextIndex = chainHead;
+            chainHead = itemIndex;
+            itemIndex = nextIndex;
+        }
+    }
+    for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
+        context->layoutElementsHashMap.internalArray[i] = -1;
+    }
+    while (chainHead != -1) {
+        Clay_LayoutElementHashMapItem *hashItem = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, chainHead);
+        int32_t nextIndex = hashItem->nextIndex;
+        uint32_t hashBucket = hashItem->elementId.id % context->layoutElementsHashMap.capacity;
+        hashItem->nextIndex = context->layoutElementsHashMap.internalArray[hashBucket];
+        context->layoutElementsHashMap.internalArray[hashBucket] = chainHead;
+        chainHead = nextIndex;
+    }
+}
+
+// Doubles the capacity of every array that scales with the element count, up to the limit set with Clay_InitializeGrowable().
+// Returns false if storage can't grow any further, in which case callers should report the capacity error they would have otherwise.
+bool Clay__GrowElementStorage(Clay_Context *context) {
+    int32_t previousCount = context->maxElementCount;
+    int32_t newCount = CLAY__MIN(previousCount * 2, Clay__ReservedElementCount(context));
+    if (newCount <= previousCount || !Clay__CommitElementStorage(context, previousCount, newCount)) {
+        return false;
+    }
+    int32_t previousBucketCount = context->layoutElementsHashMap.capacity;
+    context->maxElementCount = newCount;
+    Clay__SetEphemeralElementCapacity(context);
+    Clay__SetPersistentElementCapacity(context);
+    Clay__RehashElementHashMap(context, previousBucketCount);
+    return true;
+}
+
+bool Clay__EnsureElementCapacity(Clay_Context *context, int32_t count) {
+    while (count > context->maxElementCount) {
+        if (!Clay__GrowElementStorage(context)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The text measurement cache's bucket count is derived from the initial maxMeasureTextCacheWordCount and doesn't change,
+// only the storage for measured words grows.
+bool Clay__GrowMeasuredWordStorage(Clay_Context *context) {
+    int32_t previousCount = context->measuredWords.capacity;
+    int32_t newCount = CLAY__MIN(previousCount * 2, Clay__ReservedMeasuredWordCount(context));
+    if (newCount <= previousCount
+        || !CLAY__COMMIT_ARRAY_RANGE(context, context->measuredWords, previousCount, newCount)
+        || !CLAY__COMMIT_ARRAY_RANGE(context, context->measuredWordsFreeList, previousCount, newCount)) {
+        return false;
+    }
+    context->measuredWords.capacity = newCount;
+    context->measuredWordsFreeList.capacity = newCount;
+    return true;
+}
+
+// Commits the initial capacity of every array in a newly initialized arena.
+bool Clay__CommitInitialStorage(Clay_Context *context) {
+    return CLAY__COMMIT_ARRAY_RANGE(context, context->warnings, 0, context->warnings.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->scrollContainerDatas, 0, context->scrollContainerDatas.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->scrollContainerDataBuckets, 0, context->scrollContainerDataBuckets.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->transitionDatas, 0, context->transitionDatas.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->transitionDataBuckets, 0, context->transitionDataBuckets.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->measureTextHashMap, 0, context->measureTextHashMap.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->measuredWords, 0, context->measuredWords.capacity)
+        && CLAY__COMMIT_ARRAY_RANGE(context, context->measuredWordsFreeList, 0, context->measuredWordsFreeList.capacity)
+        && Clay__CommitElementStorage(context, 0, context->maxElementCount);
+}
+
+typedef struct {
+    Clay_String name;
+    int32_t capacity;
+    int32_t reservedCapacity;
+    int32_t length;
+    int32_t itemSize;
+} Clay__MemoryArrayInfo;
+
+#define CLAY__MEMORY_ARRAY_INFO(arrayName, array, currentCapacity, reserved) CLAY__INIT(Clay__MemoryArrayInfo) { .name = CLAY_STRING(arrayName), .capacity = (currentCapacity), .reservedCapacity = (reserved), .length = (array).length, .itemSize = (int32_t)sizeof(*(array).internalArray) }
+
+// Describes one of the context's internal arrays. capacity is the number of items that are currently usable,
+// while reservedCapacity is the number of items that address space has been set aside for.
+Clay__MemoryArrayInfo Clay__GetMemoryArrayInfo(Clay_Context *context, Clay_MemoryArrayType type) {
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t elementCount = context->maxElementCount;
+    int32_t reserved = Clay__ReservedElementCount(context);
+    switch (type) {
+        case CLAY_MEMORY_ARRAY_LAYOUT_ELEMENTS: return CLAY__MEMORY_ARRAY_INFO("layoutElements", context->layoutElements, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN: return CLAY__MEMORY_ARRAY_INFO("layoutElementChildren", context->layoutElementChildren, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER: return CLAY__MEMORY_ARRAY_INFO("layoutElementChildrenBuffer", context->layoutElementChildrenBuffer, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_ID_STRINGS: return CLAY__MEMORY_ARRAY_INFO("layoutElementIdStrings", context->layoutElementIdStrings, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CLIP_ELEMENT_IDS: return CLAY__MEMORY_ARRAY_INFO("layoutElementClipElementIds", context->layoutElementClipElementIds, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK: return CLAY__MEMORY_ARRAY_INFO("openLayoutElementStack", context->openLayoutElementStack, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_OPEN_CLIP_ELEMENT_STACK: return CLAY__MEMORY_ARRAY_INFO("openClipElementStack", context->openClipElementStack, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER: return CLAY__MEMORY_ARRAY_INFO("reusableElementIndexBuffer", context->reusableElementIndexBuffer, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODES: return CLAY__MEMORY_ARRAY_INFO("layoutElementTreeNodeArray1", context->layoutElementTreeNodeArray1, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODE_VISITED: return CLAY__MEMORY_ARRAY_INFO("treeNodeVisited", context->treeNodeVisited, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_TREE_ROOTS: return CLAY__MEMORY_ARRAY_INFO("layoutElementTreeRoots", context->layoutElementTreeRoots, context->layoutElementTreeRoots.capacity, Clay__ScaleCapacity(context, config->maxFloatingElementCount + 1, reserved));
+        case CLAY_MEMORY_ARRAY_RENDER_COMMANDS: return CLAY__MEMORY_ARRAY_INFO("renderCommands", context->renderCommands, context->renderCommands.capacity, Clay__ScaleCapacity(context, config->maxRenderCommandCount, reserved));
+        case CLAY_MEMORY_ARRAY_WRAPPED_TEXT_LINES: return CLAY__MEMORY_ARRAY_INFO("wrappedTextLines", context->wrappedTextLines, context->wrappedTextLines.capacity, Clay__ScaleCapacity(context, config->maxWrappedTextLineCount, reserved));
+        case CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_ITEMS: return CLAY__MEMORY_ARRAY_INFO("layoutElementsHashMapInternal", context->layoutElementsHashMapInternal, context->layoutElementsHashMapInternal.capacity, Clay__ScaleCapacity(context, config->maxElementIdCount, reserved));
+        case CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_BUCKETS: return CLAY__MEMORY_ARRAY_INFO("layoutElementsHashMap", context->layoutElementsHashMap, context->layoutElementsHashMap.capacity, Clay__ScaleCapacity(context, config->maxElementIdCount, reserved));
+        case CLAY_MEMORY_ARRAY_ELEMENT_HASH_MAP_FREE_LIST: return CLAY__MEMORY_ARRAY_INFO("layoutElementsHashMapFreeList", context->layoutElementsHashMapFreeList, context->layoutElementsHashMapFreeList.capacity, Clay__ScaleCapacity(context, config->maxElementIdCount, reserved));
+        case CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_ITEMS: return CLAY__MEMORY_ARRAY_INFO("measureTextHashMapInternal", context->measureTextHashMapInternal, context->measureTextHashMapInternal.capacity, Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, reserved));
+        case CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_FREE_LIST: return CLAY__MEMORY_ARRAY_INFO("measureTextHashMapInternalFreeList", context->measureTextHashMapInternalFreeList, context->measureTextHashMapInternalFreeList.capacity, Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, reserved));
+        case CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_BUCKETS: return CLAY__MEMORY_ARRAY_INFO("measureTextHashMap", context->measureTextHashMap, context->measureTextHashMap.capacity, context->measureTextHashMap.capacity);
+        case CLAY_MEMORY_ARRAY_MEASURED_WORDS: return CLAY__MEMORY_ARRAY_INFO("measuredWords", context->measuredWords, context->measuredWords.capacity, Clay__ReservedMeasuredWordCount(context));
+        case CLAY_MEMORY_ARRAY_MEASURED_WORDS_FREE_LIST: return CLAY__MEMORY_ARRAY_INFO("measuredWordsFreeList", context->measuredWordsFreeList, context->measuredWordsFreeList.capacity, Clay__ReservedMeasuredWordCount(context));
+        case CLAY_MEMORY_ARRAY_POINTER_OVER_IDS: return CLAY__MEMORY_ARRAY_INFO("pointerOverIds", context->pointerOverIds, context->pointerOverIds.capacity, Clay__ScaleCapacity(context, config->maxPointerOverIdCount, reserved));
+        case CLAY_MEMORY_ARRAY_SCROLL_CONTAINERS: return CLAY__MEMORY_ARRAY_INFO("scrollContainerDatas", context->scrollContainerDatas, context->scrollContainerDatas.capacity, context->scrollContainerDatas.capacity);
+        case CLAY_MEMORY_ARRAY_SCROLL_CONTAINER_BUCKETS: return CLAY__MEMORY_ARRAY_INFO("scrollContainerDataBuckets", context->scrollContainerDataBuckets, context->scrollContainerDataBuckets.capacity, context->scrollContainerDataBuckets.capacity);
+        case CLAY_MEMORY_ARRAY_TRANSITIONS: return CLAY__MEMORY_ARRAY_INFO("transitionDatas", context->transitionDatas, context->transitionDatas.capacity, context->transitionDatas.capacity);
+        case CLAY_MEMORY_ARRAY_TRANSITION_BUCKETS: return CLAY__MEMORY_ARRAY_INFO("transitionDataBuckets", context->transitionDataBuckets, context->transitionDataBuckets.capacity, context->transitionDataBuckets.capacity);
+        case CLAY_MEMORY_ARRAY_WARNINGS: return CLAY__MEMORY_ARRAY_INFO("warnings", context->warnings, context->warnings.capacity, context->warnings.capacity);
+        case CLAY_MEMORY_ARRAY_DEBUG_STRING_DATA: return CLAY__MEMORY_ARRAY_INFO("dynamicStringData", context->dynamicStringData, context->dynamicStringData.capacity, Clay__ScaleCapacity(context, config->debugStringDataSize, reserved));
+        case CLAY_MEMORY_ARRAY_CACHED_SIZES: return CLAY__MEMORY_ARRAY_INFO("cachedSizes", context->cachedSizes, elementCount, reserved);
+        case CLAY_MEMORY_ARRAY_LAYOUT_TREE_ROOTS_BUFFER: return CLAY__MEMORY_ARRAY_INFO("layoutElementTreeRootsBuffer", context->layoutElementTreeRootsBuffer, context->layoutElementTreeRootsBuffer.capacity, Clay__ScaleCapacity(context, config->maxFloatingElementCount + 1, reserved));
+        case CLAY_MEMORY_ARRAY_DISTRIBUTION_KEYS: return CLAY__MEMORY_ARRAY_INFO("distributionKeys", context->distributionKeys, elementCount * 3, reserved * 3);
+        default: return CLAY__INIT(Clay__MemoryArrayInfo) CLAY__DEFAULT_STRUCT;
+    }
+}
+
+// Scratch arrays are emptied again before the end of a layout, often through copies of the array struct whose length never
+// makes it back into the context. They are sampled where they hold the most items instead.
+static inline void Clay__SampleScratchArrayLength(Clay_Context *context, Clay_MemoryArrayType type, int32_t length) {
+    context->memoryArrayScratchLengths[type] = CLAY__MAX(context->memoryArrayScratchLengths[type], length);
+}
+
+void Clay__SampleMemoryArrayLengths(Clay_Context *context) {
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        int32_t length = CLAY__MAX(Clay__GetMemoryArrayInfo(context, (Clay_MemoryArrayType)i).length, context->memoryArrayScratchLengths[i]);
+        context->memoryArrayScratchLengths[i] = 0;
+        context->memoryArrayLengths[i] = length;
+        context->memoryArrayPeakLengths[i] = CLAY__MAX(context->memoryArrayPeakLengths[i], length);
+    }
+}
+
 Clay_String Clay__WriteStringToCharBuffer(Clay__charArray *buffer, Clay_String string) {
     for (int32_t i = 0; i < string.length; i++) {
         buffer->internalArray[buffer->length + i] = string.chars[i];
@@ -1403,6 +2293,319 @@ Clay_String Clay__WriteStringToCharBuffer(Clay__charArray *buffer, Clay_String s
     Clay_Vector2 (*Clay__QueryScrollOffset)(uint32_t elementId, void *userData);
 #endif
 
+#ifdef CLAY_RECORDING
+// Recording format: the header "CLAYREC" followed by a version byte, then a stream of events, each starting with a
+// Clay__RecordEventType byte. Integers are written as LEB128 varints, floats as 4 little endian bytes and strings as
+// a varint length followed by the characters. Declarations only include the config groups that are non zero.
+// Any change to this format needs a matching change to benchmarks/replay.c
+#define CLAY__RECORD_FORMAT_VERSION 1
+
+typedef CLAY_PACKED_ENUM {
+    CLAY__RECORD_EVENT_TYPE_LAYOUT_DIMENSIONS = 1,
+    CLAY__RECORD_EVENT_TYPE_POINTER_STATE,
+    CLAY__RECORD_EVENT_TYPE_UPDATE_SCROLL_CONTAINERS,
+    CLAY__RECORD_EVENT_TYPE_BEGIN_LAYOUT,
+    CLAY__RECORD_EVENT_TYPE_OPEN_ELEMENT,
+    CLAY__RECORD_EVENT_TYPE_OPEN_ELEMENT_WITH_ID,
+    CLAY__RECORD_EVENT_TYPE_CONFIGURE_ELEMENT,
+    CLAY__RECORD_EVENT_TYPE_CLOSE_ELEMENT,
+    CLAY__RECORD_EVENT_TYPE_TEXT_ELEMENT,
+    CLAY__RECORD_EVENT_TYPE_END_LAYOUT,
+    CLAY__RECORD_EVENT_TYPE_MEASURE_TEXT,
+} Clay__RecordEventType;
+
+// Bits for the config groups present in a CLAY__RECORD_EVENT_TYPE_CONFIGURE_ELEMENT event
+typedef enum {
+    CLAY__RECORD_CONFIG_LAYOUT = 1 << 0,
+    CLAY__RECORD_CONFIG_BACKGROUND_COLOR = 1 << 1,
+    CLAY__RECORD_CONFIG_OVERLAY_COLOR = 1 << 2,
+    CLAY__RECORD_CONFIG_CORNER_RADIUS = 1 << 3,
+    CLAY__RECORD_CONFIG_ASPECT_RATIO = 1 << 4,
+    CLAY__RECORD_CONFIG_IMAGE = 1 << 5,
+    CLAY__RECORD_CONFIG_FLOATING = 1 << 6,
+    CLAY__RECORD_CONFIG_CUSTOM = 1 << 7,
+    CLAY__RECORD_CONFIG_CLIP = 1 << 8,
+    CLAY__RECORD_CONFIG_BORDER = 1 << 9,
+    CLAY__RECORD_CONFIG_TRANSITION = 1 << 10,
+} Clay__RecordConfigFlags;
+
+void Clay__FlushRecordBuffer(Clay_Context *context) {
+    if (context->recordBufferLength > 0 && context->recorder.writeFunction) {
+        context->recorder.writeFunction(context->recordBuffer, (size_t)context->recordBufferLength, context->recorder.userData);
+    }
+    context->recordBufferLength = 0;
+}
+
+void Clay__RecordBytes(Clay_Context *context, const void *data, int32_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (int32_t i = 0; i < length; ++i) {
+        if (context->recordBufferLength == CLAY__RECORD_BUFFER_SIZE) {
+            Clay__FlushRecordBuffer(context);
+        }
+        context->recordBuffer[context->recordBufferLength++] = bytes[i];
+    }
+}
+
+void Clay__RecordUInt8(Clay_Context *context, uint8_t value) {
+    Clay__RecordBytes(context, &value, 1);
+}
+
+void Clay__RecordVarUInt(Clay_Context *context, uint32_t value) {
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        Clay__RecordUInt8(context, (uint8_t)(byte | (value > 0 ? 0x80 : 0)));
+    } while (value > 0);
+}
+
+void Clay__RecordFloat(Clay_Context *context, float value) {
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    uint8_t bytes[4] = { (uint8_t)bits.u, (uint8_t)(bits.u >> 8), (uint8_t)(bits.u >> 16), (uint8_t)(bits.u >> 24) };
+    Clay__RecordBytes(context, bytes, 4);
+}
+
+void Clay__RecordString(Clay_Context *context, const char *chars, int32_t length) {
+    Clay__RecordVarUInt(context, (uint32_t)length);
+    Clay__RecordBytes(context, chars, length);
+}
+
+void Clay__RecordColor(Clay_Context *context, Clay_Color color) {
+    Clay__RecordFloat(context, color.r);
+    Clay__RecordFloat(context, color.g);
+    Clay__RecordFloat(context, color.b);
+    Clay__RecordFloat(context, color.a);
+}
+
+void Clay__RecordSizingAxis(Clay_Context *context, Clay_SizingAxis axis) {
+    Clay__RecordUInt8(context, (uint8_t)axis.type);
+    if (axis.type == CLAY__SIZING_TYPE_PERCENT) {
+        Clay__RecordFloat(context, axis.size.percent);
+    } else {
+        Clay__RecordFloat(context, axis.size.minMax.min);
+        Clay__RecordFloat(context, axis.size.minMax.max);
+    }
+}
+
+bool Clay__RecordIsZero(const void *data, int32_t length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (int32_t i = 0; i < length; ++i) {
+        if (bytes[i] != 0) return false;
+    }
+    return true;
+}
+
+// Returns true if events should be recorded, writing the header first if this is the start of the recording
+bool Clay__RecordEvent(Clay_Context *context, Clay__RecordEventType type) {
+    if (!context->recorder.writeFunction) {
+        return false;
+    }
+    if (!context->recordingHeaderWritten) {
+        Clay__RecordBytes(context, "CLAYREC", 7);
+        Clay__RecordUInt8(context, CLAY__RECORD_FORMAT_VERSION);
+        context->recordingHeaderWritten = true;
+    }
+    Clay__RecordUInt8(context, (uint8_t)type);
+    return true;
+}
+
+void Clay__RecordTextConfig(Clay_Context *context, Clay_TextElementConfig *config) {
+    Clay__RecordColor(context, config->textColor);
+    Clay__RecordVarUInt(context, config->fontId);
+    Clay__RecordVarUInt(context, config->fontSize);
+    Clay__RecordVarUInt(context, config->letterSpacing);
+    Clay__RecordVarUInt(context, config->lineHeight);
+    Clay__RecordUInt8(context, (uint8_t)config->wrapMode);
+    Clay__RecordUInt8(context, (uint8_t)config->textAlignment);
+}
+
+void Clay__RecordDeclaration(Clay_Context *context, const Clay_ElementDeclaration *declaration) {
+    if (!context->recordingDeclarations || !Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_CONFIGURE_ELEMENT)) {
+        return;
+    }
+    uint32_t flags = 0;
+    if (!Clay__RecordIsZero(&declaration->layout, sizeof(declaration->layout))) flags |= CLAY__RECORD_CONFIG_LAYOUT;
+    if (!Clay__RecordIsZero(&declaration->backgroundColor, sizeof(declaration->backgroundColor))) flags |= CLAY__RECORD_CONFIG_BACKGROUND_COLOR;
+    if (!Clay__RecordIsZero(&declaration->overlayColor, sizeof(declaration->overlayColor))) flags |= CLAY__RECORD_CONFIG_OVERLAY_COLOR;
+    if (!Clay__RecordIsZero(&declaration->cornerRadius, sizeof(declaration->cornerRadius))) flags |= CLAY__RECORD_CONFIG_CORNER_RADIUS;
+    if (declaration->aspectRatio.aspectRatio != 0) flags |= CLAY__RECORD_CONFIG_ASPECT_RATIO;
+    if (declaration->image.imageData) flags |= CLAY__RECORD_CONFIG_IMAGE;
+    if (!Clay__RecordIsZero(&declaration->floating, sizeof(declaration->floating))) flags |= CLAY__RECORD_CONFIG_FLOATING;
+    if (declaration->custom.customData) flags |= CLAY__RECORD_CONFIG_CUSTOM;
+    if (!Clay__RecordIsZero(&declaration->clip, sizeof(declaration->clip))) flags |= CLAY__RECORD_CONFIG_CLIP;
+    if (!Clay__RecordIsZero(&declaration->border, sizeof(declaration->border))) flags |= CLAY__RECORD_CONFIG_BORDER;
+    if (declaration->transition.handler) flags |= CLAY__RECORD_CONFIG_TRANSITION;
+    Clay__RecordVarUInt(context, flags);
+
+    if (flags & CLAY__RECORD_CONFIG_LAYOUT) {
+        const Clay_LayoutConfig *layout = &declaration->layout;
+        Clay__RecordSizingAxis(context, layout->sizing.width);
+        Clay__RecordSizingAxis(context, layout->sizing.height);
+        Clay__RecordVarUInt(context, layout->padding.left);
+        Clay__RecordVarUInt(context, layout->padding.right);
+        Clay__RecordVarUInt(context, layout->padding.top);
+        Clay__RecordVarUInt(context, layout->padding.bottom);
+        Clay__RecordVarUInt(context, layout->childGap);
+        Clay__RecordUInt8(context, (uint8_t)layout->childAlignment.x);
+        Clay__RecordUInt8(context, (uint8_t)layout->childAlignment.y);
+        Clay__RecordUInt8(context, (uint8_t)layout->layoutDirection);
+    }
+    if (flags & CLAY__RECORD_CONFIG_BACKGROUND_COLOR) Clay__RecordColor(context, declaration->backgroundColor);
+    if (flags & CLAY__RECORD_CONFIG_OVERLAY_COLOR) Clay__RecordColor(context, declaration->overlayColor);
+    if (flags & CLAY__RECORD_CONFIG_CORNER_RADIUS) {
+        Clay__RecordFloat(context, declaration->cornerRadius.topLeft);
+        Clay__RecordFloat(context, declaration->cornerRadius.topRight);
+        Clay__RecordFloat(context, declaration->cornerRadius.bottomLeft);
+        Clay__RecordFloat(context, declaration->cornerRadius.bottomRight);
+    }
+    if (flags & CLAY__RECORD_CONFIG_ASPECT_RATIO) Clay__RecordFloat(context, declaration->aspectRatio.aspectRatio);
+    if (flags & CLAY__RECORD_CONFIG_FLOATING) {
+        const Clay_FloatingElementConfig *floating = &declaration->floating;
+        Clay__RecordFloat(context, floating->offset.x);
+        Clay__RecordFloat(context, floating->offset.y);
+        Clay__RecordFloat(context, floating->expand.width);
+        Clay__RecordFloat(context, floating->expand.height);
+        Clay__RecordVarUInt(context, floating->parentId);
+        Clay__RecordVarUInt(context, (uint32_t)(floating->zIndex + 32768));
+        Clay__RecordUInt8(context, (uint8_t)floating->attachPoints.element);
+        Clay__RecordUInt8(context, (uint8_t)floating->attachPoints.parent);
+        Clay__RecordUInt8(context, (uint8_t)floating->pointerCaptureMode);
+        Clay__RecordUInt8(context, (uint8_t)floating->attachTo);
+        Clay__RecordUInt8(context, (uint8_t)floating->clipTo);
+    }
+    if (flags & CLAY__RECORD_CONFIG_CLIP) {
+        Clay__RecordUInt8(context, (uint8_t)declaration->clip.horizontal);
+        Clay__RecordUInt8(context, (uint8_t)declaration->clip.vertical);
+        Clay__RecordFloat(context, declaration->clip.childOffset.x);
+        Clay__RecordFloat(context, declaration->clip.childOffset.y);
+    }
+    if (flags & CLAY__RECORD_CONFIG_BORDER) {
+        Clay__RecordColor(context, declaration->border.color);
+        Clay__RecordVarUInt(context, declaration->border.width.left);
+        Clay__RecordVarUInt(context, declaration->border.width.right);
+        Clay__RecordVarUInt(context, declaration->border.width.top);
+        Clay__RecordVarUInt(context, declaration->border.width.bottom);
+        Clay__RecordVarUInt(context, declaration->border.width.betweenChildren);
+    }
+    // Callbacks can't be recorded - the replay tool substitutes Clay_EaseOut and transitions that leave the state unchanged
+    if (flags & CLAY__RECORD_CONFIG_TRANSITION) {
+        const Clay_TransitionElementConfig *transition = &declaration->transition;
+        Clay__RecordFloat(context, transition->duration);
+        Clay__RecordVarUInt(context, (uint32_t)transition->properties);
+        Clay__RecordUInt8(context, (uint8_t)transition->interactionHandling);
+        Clay__RecordUInt8(context, (uint8_t)(transition->enter.setInitialState != NULL));
+        Clay__RecordUInt8(context, (uint8_t)transition->enter.trigger);
+        Clay__RecordUInt8(context, (uint8_t)(transition->exit.setFinalState != NULL));
+        Clay__RecordUInt8(context, (uint8_t)transition->exit.trigger);
+        Clay__RecordUInt8(context, (uint8_t)transition->exit.siblingOrdering);
+    }
+}
+
+void Clay__RecordOpenElement(Clay_Context *context, const Clay_ElementId *elementId) {
+    if (!context->recordingDeclarations) {
+        return;
+    }
+    if (!elementId) {
+        Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_OPEN_ELEMENT);
+    } else if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_OPEN_ELEMENT_WITH_ID)) {
+        Clay__RecordVarUInt(context, elementId->id);
+        Clay__RecordVarUInt(context, elementId->offset);
+        Clay__RecordVarUInt(context, elementId->baseId);
+        Clay__RecordString(context, elementId->stringId.chars, elementId->stringId.length);
+    }
+}
+
+void Clay__RecordCloseElement(Clay_Context *context) {
+    if (context->recordingDeclarations) {
+        Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_CLOSE_ELEMENT);
+    }
+}
+
+void Clay__RecordTextElement(Clay_Context *context, Clay_String text, Clay_TextElementConfig *config) {
+    if (context->recordingDeclarations && Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_TEXT_ELEMENT)) {
+        Clay__RecordString(context, text.chars, text.length);
+        Clay__RecordTextConfig(context, config);
+    }
+}
+
+void Clay__RecordMeasureText(Clay_Context *context, Clay_StringSlice text, Clay_TextElementConfig *config, Clay_Dimensions dimensions) {
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_MEASURE_TEXT)) {
+        Clay__RecordString(context, text.chars, text.length);
+        Clay__RecordTextConfig(context, config);
+        Clay__RecordFloat(context, dimensions.width);
+        Clay__RecordFloat(context, dimensions.height);
+    }
+}
+#endif
+
+#ifdef CLAY_TRACING
+void Clay__RecordTraceEvent(Clay_Context *context, Clay__TraceEventType type, Clay_String name, Clay_String argName, uint32_t value) {
+    if (!context->traceEvents) {
+        return;
+    }
+    Clay_InstrumentationHooks *hooks = &context->instrumentationHooks;
+    context->traceEvents[context->traceEventCount % (uint64_t)context->traceEventCapacity] = CLAY__INIT(Clay__TraceEvent) {
+        .timestamp = hooks->timeFunction ? hooks->timeFunction(hooks->userData) : 0,
+        .name = name,
+        .argName = argName,
+        .value = value,
+        .type = type,
+    };
+    context->traceEventCount++;
+}
+#endif
+
+void Clay__RecordFlightRecorderFrame(Clay_Context *context, float deltaTime) {
+    Clay_FrameStats *stats = &context->lastFrameStats;
+    Clay_BooleanWarnings *warnings = &context->booleanWarnings;
+    Clay_FlightRecorderFrame *frame = &context->flightRecorderFrames[context->flightRecorderFrameCount % CLAY_FLIGHT_RECORDER_FRAME_COUNT];
+    frame->frameIndex = context->generation;
+    frame->deltaTime = deltaTime;
+    for (int32_t i = 0; i < CLAY_LAYOUT_PHASE_COUNT; ++i) {
+        frame->phaseTimes[i] = (uint32_t)stats->phaseTimes[i];
+    }
+    frame->totalTime = (uint32_t)stats->totalTime;
+    frame->elementCount = stats->elementCount;
+    frame->renderCommandCount = stats->renderCommandCount;
+    frame->measureTextCacheMissCount = stats->measureTextCacheMissCount;
+    frame->warningCount = context->warnings.length;
+    frame->capacityErrors = (warnings->maxElementsExceeded ? CLAY_CAPACITY_ERROR_ELEMENTS : 0)
+        | (warnings->maxRenderCommandsExceeded ? CLAY_CAPACITY_ERROR_RENDER_COMMANDS : 0)
+        | (warnings->maxTextMeasureCacheExceeded ? CLAY_CAPACITY_ERROR_MEASURE_TEXT_CACHE : 0)
+        | (warnings->hashMapCapacityExceeded ? CLAY_CAPACITY_ERROR_HASH_MAP : 0)
+        | (warnings->textMeasurementFunctionNotSet ? CLAY_CAPACITY_ERROR_TEXT_MEASUREMENT_FUNCTION_NOT_SET : 0);
+    context->flightRecorderFrameCount++;
+}
+
+Clay_Dimensions Clay__CallMeasureText(Clay_Context *context, Clay_StringSlice text, Clay_TextElementConfig *config) {
+    context->frameStats.measureTextCallCount++;
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, CLAY_STRING("MeasureText"), CLAY_STRING("length"), (uint32_t)text.length);
+    Clay_Dimensions dimensions = Clay__MeasureText(text, config, context->measureTextUserData);
+    CLAY__RECORD(Clay__RecordMeasureText(context, text, config, dimensions));
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, CLAY_STRING("MeasureText"), CLAY__STRING_DEFAULT, 0);
+    return dimensions;
+}
+
+uint64_t Clay__BeginPhase(Clay_Context *context, Clay_LayoutPhase phase) {
+    Clay_InstrumentationHooks *hooks = &context->instrumentationHooks;
+    if (hooks->phaseBeginFunction) {
+        hooks->phaseBeginFunction(phase, hooks->userData);
+    }
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, Clay_GetLayoutPhaseName(phase), CLAY__STRING_DEFAULT, 0);
+    return hooks->timeFunction ? hooks->timeFunction(hooks->userData) : 0;
+}
+
+void Clay__EndPhase(Clay_Context *context, Clay_LayoutPhase phase, uint64_t startTime) {
+    Clay_InstrumentationHooks *hooks = &context->instrumentationHooks;
+    if (hooks->timeFunction) {
+        context->frameStats.phaseTimes[phase] += hooks->timeFunction(hooks->userData) - startTime;
+    }
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, Clay_GetLayoutPhaseName(phase), CLAY__STRING_DEFAULT, 0);
+    if (hooks->phaseEndFunction) {
+        hooks->phaseEndFunction(phase, hooks->userData);
+    }
+}
+
 Clay_LayoutElement* Clay__GetOpenLayoutElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
     return Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&context->openLayoutElementStack, context->openLayoutElementStack.length - 1));
@@ -1651,13 +2854,14 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     }
     #endif
     uint32_t id = Clay__HashStringContentsWithConfig(text, config);
-    uint32_t hashBucket = id % (context->maxMeasureTextCacheWordCount / 32);
+    uint32_t hashBucket = id % context->measureTextHashMap.capacity;
     int32_t elementIndexPrevious = 0;
     int32_t elementIndex = context->measureTextHashMap.internalArray[hashBucket];
     while (elementIndex != 0) {
         Clay__MeasureTextCacheItem *hashEntry = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, elementIndex);
         if (hashEntry->id == id) {
             hashEntry->generation = context->generation;
+            context->frameStats.measureTextCacheHitCount++;
             return hashEntry;
         }
         // This element hasn't been seen in a few frames, delete the hash map item
@@ -1686,6 +2890,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         }
     }
 
+    context->frameStats.measureTextCacheMissCount++;
     int32_t newItemIndex = 0;
     Clay__MeasureTextCacheItem newCacheItem = { .measuredWordsStartIndex = -1, .id = id, .generation = context->generation };
     Clay__MeasureTextCacheItem *measured = NULL;
@@ -1695,7 +2900,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         Clay__MeasureTextCacheItemArray_Set(&context->measureTextHashMapInternal, newItemIndex, newCacheItem);
         measured = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, newItemIndex);
     } else {
-        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1) {
+        if (context->measureTextHashMapInternal.length == context->measureTextHashMapInternal.capacity - 1 && !Clay__GrowElementStorage(context)) {
             if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
                 context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                         .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
@@ -1714,11 +2919,11 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
     float lineWidth = 0;
     float measuredWidth = 0;
     float measuredHeight = 0;
-    float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config, context->measureTextUserData).width;
+    float spaceWidth = Clay__CallMeasureText(context, CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, config).width;
     Clay__MeasuredWord tempWord = { .next = -1 };
     Clay__MeasuredWord *previousWord = &tempWord;
     while (end < text->length) {
-        if (context->measuredWords.length == context->measuredWords.capacity - 1) {
+        if (context->measuredWords.length == context->measuredWords.capacity - 1 && !Clay__GrowMeasuredWordStorage(context)) {
             if (!context->booleanWarnings.maxTextMeasureCacheExceeded) {
                 context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                     .errorType = CLAY_ERROR_TYPE_TEXT_MEASUREMENT_CAPACITY_EXCEEDED,
@@ -1733,7 +2938,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
             int32_t length = end - start;
             Clay_Dimensions dimensions = CLAY__DEFAULT_STRUCT;
             if (length > 0) {
-                dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config, context->measureTextUserData);
+                dimensions = Clay__CallMeasureText(context, CLAY__INIT(Clay_StringSlice) {.length = length, .chars = &text->chars[start], .baseChars = text->chars}, config);
             }
             measured->minWidth = CLAY__MAX(dimensions.width, measured->minWidth);
             measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
@@ -1757,7 +2962,7 @@ Clay__MeasureTextCacheItem *Clay__MeasureTextCached(Clay_String *text, Clay_Text
         end++;
     }
     if (end - start > 0) {
-        Clay_Dimensions dimensions = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config, context->measureTextUserData);
+        Clay_Dimensions dimensions = Clay__CallMeasureText(context, CLAY__INIT(Clay_StringSlice) { .length = end - start, .chars = &text->chars[start], .baseChars = text->chars }, config);
         Clay__AddMeasuredWord(CLAY__INIT(Clay__MeasuredWord) { .startOffset = start, .length = end - start, .width = dimensions.width, .next = -1 }, previousWord);
         lineWidth += dimensions.width;
         measuredHeight = CLAY__MAX(measuredHeight, dimensions.height);
@@ -1783,7 +2988,7 @@ bool Clay__PointIsInsideRect(Clay_Vector2 point, Clay_BoundingBox rect) {
 
 Clay_LayoutElementHashMapItem* Clay__AddHashMapItem(Clay_ElementId elementId, Clay_LayoutElement* layoutElement) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1) {
+    if (context->layoutElementsHashMapInternal.length == context->layoutElementsHashMapInternal.capacity - 1 && !Clay__GrowElementStorage(context)) {
         if (!context->booleanWarnings.hashMapCapacityExceeded) {
             context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
                 .errorType = CLAY_ERROR_TYPE_HASH_MAP_CAPACITY_EXCEEDED,
@@ -1864,8 +3069,61 @@ void Clay__UpdateAspectRatioBox(Clay_LayoutElement *layoutElement) {
     }
 }
 
+static inline uint64_t Clay__HashSizingValue(uint64_t hash, uint32_t value) {
+    return (hash ^ value) * 1099511628211ULL;
+}
+
+static inline uint64_t Clay__HashSizingFloat(uint64_t hash, float value) {
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    return Clay__HashSizingValue(hash, bits.u);
+}
+
+static inline uint64_t Clay__HashSizingAxis(uint64_t hash, Clay_SizingAxis axis) {
+    hash = Clay__HashSizingValue(hash, axis.type);
+    hash = Clay__HashSizingFloat(hash, axis.size.minMax.min);
+    return Clay__HashSizingFloat(hash, axis.size.minMax.max);
+}
+
+// Accumulates the inputs of the sizing and text wrapping phases for a closed element into context->sizingHash.
+// Position only properties like childAlignment, floating offsets and clip.childOffset are left out, so that frames
+// which only scroll or move floating elements can reuse the previous frame's sizes (see Clay__CalculateSizesWithCache).
+void Clay__HashSizingInputs(Clay_Context *context, Clay_LayoutElement *element, uint32_t textMeasurementId) {
+    uint64_t hash = context->sizingHash;
+    hash = Clay__HashSizingValue(hash, element->id);
+    hash = Clay__HashSizingValue(hash, element->children.length | (uint32_t)element->isTextElement << 16);
+    // The root container's size is compared separately, so that frames which only resize the window can still reuse text wrapping
+    if (element == context->layoutElements.internalArray) {
+        context->sizingHash = hash;
+        return;
+    }
+    hash = Clay__HashSizingFloat(hash, element->dimensions.width);
+    hash = Clay__HashSizingFloat(hash, element->dimensions.height);
+    hash = Clay__HashSizingFloat(hash, element->minDimensions.width);
+    hash = Clay__HashSizingFloat(hash, element->minDimensions.height);
+    if (element->isTextElement) {
+        // Text that couldn't be cached has no stable id, so never reuse sizes for a frame that contains it
+        hash = Clay__HashSizingValue(hash, textMeasurementId ? textMeasurementId : context->generation);
+        hash = Clay__HashSizingValue(hash, element->textConfig.wrapMode | (uint32_t)element->textConfig.lineHeight << 8);
+    } else {
+        Clay_LayoutConfig *layoutConfig = &element->config.layout;
+        hash = Clay__HashSizingAxis(hash, layoutConfig->sizing.width);
+        hash = Clay__HashSizingAxis(hash, layoutConfig->sizing.height);
+        hash = Clay__HashSizingValue(hash, layoutConfig->padding.left | (uint32_t)layoutConfig->padding.right << 16);
+        hash = Clay__HashSizingValue(hash, layoutConfig->padding.top | (uint32_t)layoutConfig->padding.bottom << 16);
+        hash = Clay__HashSizingValue(hash, layoutConfig->childGap | (uint32_t)layoutConfig->layoutDirection << 16);
+        hash = Clay__HashSizingFloat(hash, element->config.aspectRatio.aspectRatio);
+        hash = Clay__HashSizingValue(hash, element->config.floating.attachTo | (uint32_t)element->config.clip.horizontal << 8 | (uint32_t)element->config.clip.vertical << 9);
+        hash = Clay__HashSizingValue(hash, element->config.floating.parentId);
+        hash = Clay__HashSizingFloat(hash, element->config.floating.expand.width);
+        hash = Clay__HashSizingFloat(hash, element->config.floating.expand.height);
+    }
+    context->sizingHash = hash;
+}
+
 void Clay__CloseElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    CLAY__RECORD(Clay__RecordCloseElement(context));
     if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
@@ -1874,6 +3132,7 @@ void Clay__CloseElement(void) {
     bool elementHasClipHorizontal = openLayoutElement->config.clip.horizontal;
     bool elementHasClipVertical = openLayoutElement->config.clip.vertical;
     if (elementHasClipHorizontal || elementHasClipVertical || openLayoutElement->config.floating.attachTo != CLAY_ATTACH_TO_NONE) {
+        Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_CLIP_ELEMENT_STACK, context->openClipElementStack.length);
         context->openClipElementStack.length--;
     }
 
@@ -1929,6 +3188,7 @@ void Clay__CloseElement(void) {
         }
     }
 
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER, context->layoutElementChildrenBuffer.length);
     context->layoutElementChildrenBuffer.length -= openLayoutElement->children.length;
 
     // Clamp element min and max width to the values configured in the layout
@@ -1954,10 +3214,12 @@ void Clay__CloseElement(void) {
     }
 
     Clay__UpdateAspectRatioBox(openLayoutElement);
+    Clay__HashSizingInputs(context, openLayoutElement, 0);
 
     bool elementIsFloating = openLayoutElement->config.floating.attachTo != CLAY_ATTACH_TO_NONE;
 
     // Close the currently open element
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK, context->openLayoutElementStack.length);
     int32_t closingElementIndex = Clay__int32_tArray_RemoveSwapback(&context->openLayoutElementStack, (int)context->openLayoutElementStack.length - 1);
 
     // Get the currently open parent
@@ -2040,7 +3302,8 @@ bool Clay__MemCmp(const char *s1, const char *s2, int32_t length);
 
 void Clay__OpenElement(void) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    CLAY__RECORD(Clay__RecordOpenElement(context, NULL));
+    if ((context->layoutElements.length == context->maxElementCount - 1 && !Clay__GrowElementStorage(context)) || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2063,7 +3326,8 @@ void Clay__OpenElement(void) {
 
 void Clay__OpenElementWithId(Clay_ElementId elementId) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    CLAY__RECORD(Clay__RecordOpenElement(context, &elementId));
+    if ((context->layoutElements.length == context->maxElementCount - 1 && !Clay__GrowElementStorage(context)) || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2082,7 +3346,8 @@ void Clay__OpenElementWithId(Clay_ElementId elementId) {
 
 void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig textConfig) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->layoutElements.length == context->layoutElements.capacity - 1 || context->booleanWarnings.maxElementsExceeded) {
+    CLAY__RECORD(Clay__RecordTextElement(context, text, &textConfig));
+    if ((context->layoutElements.length == context->maxElementCount - 1 && !Clay__GrowElementStorage(context)) || context->booleanWarnings.maxElementsExceeded) {
         context->booleanWarnings.maxElementsExceeded = true;
         return;
     }
@@ -2090,6 +3355,7 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig textConfig)
 
     Clay_LayoutElement layoutElement = { .textConfig = textConfig, .isTextElement = true };
     Clay_LayoutElement *textElement = Clay_LayoutElementArray_Add(&context->layoutElements, layoutElement);
+    context->frameStats.textElementCount++;
     if (context->openClipElementStack.length > 0) {
         Clay__int32_tArray_Set(&context->layoutElementClipElementIds, context->layoutElements.length - 1, Clay__int32_tArray_GetValue(&context->openClipElementStack, (int)context->openClipElementStack.length - 1));
     } else {
@@ -2106,11 +3372,13 @@ void Clay__OpenTextElement(Clay_String text, Clay_TextElementConfig textConfig)
     textElement->dimensions = textDimensions;
     textElement->minDimensions = CLAY__INIT(Clay_Dimensions) { .width = textMeasured->minWidth, .height = textDimensions.height };
     textElement->textElementData = CLAY__INIT(Clay__TextElementData) { .text = text, .preferredDimensions = textMeasured->unwrappedDimensions };
+    Clay__HashSizingInputs(context, textElement, textMeasured->id);
     parentElement->children.length++;
 }
 
 void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     Clay_Context* context = Clay_GetCurrentContext();
+    CLAY__RECORD(Clay__RecordDeclaration(context, declaration));
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
     openLayoutElement->config = *declaration;
     if ((declaration->layout.sizing.width.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.width.size.percent > 1) || (declaration->layout.sizing.height.type == CLAY__SIZING_TYPE_PERCENT && declaration->layout.sizing.height.size.percent > 1)) {
@@ -2163,17 +3431,12 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     if (declaration->clip.horizontal || declaration->clip.vertical) {
         Clay__int32_tArray_Add(&context->openClipElementStack, (int)openLayoutElement->id);
         // Retrieve or create cached data to track scroll position across frames
-        Clay__ScrollContainerDataInternal *scrollOffset = CLAY__NULL;
-        for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-            Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-            if (openLayoutElement->id == mapping->elementId) {
-                scrollOffset = mapping;
-                scrollOffset->layoutElement = openLayoutElement;
-                scrollOffset->openThisFrame = true;
-            }
-        }
-        if (!scrollOffset) {
-            scrollOffset = Clay__ScrollContainerDataInternalArray_Add(&context->scrollContainerDatas, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
+        Clay__ScrollContainerDataInternal *scrollOffset = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, openLayoutElement->id);
+        if (scrollOffset) {
+            scrollOffset->layoutElement = openLayoutElement;
+            scrollOffset->openThisFrame = true;
+        } else {
+            scrollOffset = Clay__ScrollContainerDataInternalArray_Insert(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, CLAY__INIT(Clay__ScrollContainerDataInternal){.layoutElement = openLayoutElement, .scrollOrigin = {-1,-1}, .elementId = openLayoutElement->id, .openThisFrame = true});
         }
         if (context->externalScrollHandlingEnabled) {
             scrollOffset->scrollPosition = Clay__QueryScrollOffset(scrollOffset->elementId, context->queryScrollOffsetUserData);
@@ -2181,28 +3444,23 @@ void Clay__ConfigureOpenElementPtr(const Clay_ElementDeclaration *declaration) {
     }
     // Setup data to track transitions across frames
     if (declaration->transition.handler) {
-        Clay__TransitionDataInternal *transitionData = CLAY__NULL;
         Clay_LayoutElement* parentElement = Clay__GetParentElement();
-        for (int32_t i = 0; i < context->transitionDatas.length; i++) {
-            Clay__TransitionDataInternal *existingData = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
-            if (openLayoutElement->id == existingData->elementId) {
-                if (existingData->state == CLAY_TRANSITION_STATE_EXITING) {
-                    existingData->state = CLAY_TRANSITION_STATE_IDLE;
-                    Clay_LayoutElementHashMapItem* hashMapItem = Clay__GetHashMapItem(openLayoutElement->id);
-                    hashMapItem->appearedThisFrame = false;
-                }
-                transitionData = existingData;
-                transitionData->elementThisFrame = openLayoutElement;
-                if (transitionData->parentId != parentElement->id) {
-                    transitionData->reparented = true;
-                }
-                transitionData->parentId = parentElement->id;
-                transitionData->siblingIndex = parentElement->children.length;
-                transitionData->transitionOut = !!declaration->transition.exit.setFinalState;
+        Clay__TransitionDataInternal *transitionData = Clay__TransitionDataInternalArray_Find(&context->transitionDatas, &context->transitionDataBuckets, openLayoutElement->id);
+        if (transitionData) {
+            if (transitionData->state == CLAY_TRANSITION_STATE_EXITING) {
+                transitionData->state = CLAY_TRANSITION_STATE_IDLE;
+                Clay_LayoutElementHashMapItem* hashMapItem = Clay__GetHashMapItem(openLayoutElement->id);
+                hashMapItem->appearedThisFrame = false;
             }
-        }
-        if (!transitionData) {
-            transitionData = Clay__TransitionDataInternalArray_Add(&context->transitionDatas, CLAY__INIT(Clay__TransitionDataInternal){
+            transitionData->elementThisFrame = openLayoutElement;
+            if (transitionData->parentId != parentElement->id) {
+                transitionData->reparented = true;
+            }
+            transitionData->parentId = parentElement->id;
+            transitionData->siblingIndex = parentElement->children.length;
+            transitionData->transitionOut = !!declaration->transition.exit.setFinalState;
+        } else {
+            transitionData = Clay__TransitionDataInternalArray_Insert(&context->transitionDatas, &context->transitionDataBuckets, CLAY__INIT(Clay__TransitionDataInternal){
                 .elementThisFrame = openLayoutElement,
                 .elementId = openLayoutElement->id,
                 .parentId = parentElement->id,
@@ -2218,48 +3476,61 @@ void Clay__ConfigureOpenElement(const Clay_ElementDeclaration declaration) {
 }
 
 void Clay__InitializeEphemeralMemory(Clay_Context* context) {
-    int32_t maxElementCount = context->maxElementCount;
+    // Arrays are allocated with their reserved capacity so that they can grow in place, see Clay__GrowElementStorage()
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t reservedElementCount = Clay__ReservedElementCount(context);
     // Ephemeral Memory - reset every frame
     Clay_Arena *arena = &context->internalArena;
     arena->nextAllocation = context->arenaResetOffset;
 
-    context->layoutElementChildrenBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElements = Clay_LayoutElementArray_Allocate_Arena(maxElementCount, arena);
-    context->warnings = Clay__WarningArray_Allocate_Arena(100, arena);
-
-    context->layoutElementIdStrings = Clay__StringArray_Allocate_Arena(maxElementCount, arena);
-    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->renderCommands = Clay_RenderCommandArray_Allocate_Arena(maxElementCount, arena);
-    context->treeNodeVisited = Clay__boolArray_Allocate_Arena(maxElementCount, arena);
-    context->treeNodeVisited.length = context->treeNodeVisited.capacity; // This array is accessed directly rather than behaving as a list
-    context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->dynamicStringData = Clay__charArray_Allocate_Arena(maxElementCount, arena);
+    context->layoutElementChildrenBuffer = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->layoutElements = Clay_LayoutElementArray_Allocate_Arena(reservedElementCount, arena);
+    context->warnings = Clay__WarningArray_Allocate_Arena(config->maxWarningCount, arena);
+
+    context->layoutElementIdStrings = Clay__StringArray_Allocate_Arena(reservedElementCount, arena);
+    context->wrappedTextLines = Clay__WrappedTextLineArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxWrappedTextLineCount, reservedElementCount), arena);
+    context->layoutElementTreeNodeArray1 = Clay__LayoutElementTreeNodeArray_Allocate_Arena(reservedElementCount, arena);
+    context->layoutElementTreeRoots = Clay__LayoutElementTreeRootArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxFloatingElementCount + 1, reservedElementCount), arena);
+    context->layoutElementTreeRootsBuffer = Clay__LayoutElementTreeRootArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxFloatingElementCount + 1, reservedElementCount), arena);
+    context->layoutElementChildren = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->openLayoutElementStack = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->renderCommands = Clay_RenderCommandArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxRenderCommandCount, reservedElementCount), arena);
+    context->treeNodeVisited = Clay__boolArray_Allocate_Arena(reservedElementCount, arena);
+    context->openClipElementStack = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->reusableElementIndexBuffer = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->distributionKeys = Clay__uint32_tArray_Allocate_Arena(reservedElementCount * 3, arena);
+    context->layoutElementClipElementIds = Clay__int32_tArray_Allocate_Arena(reservedElementCount, arena);
+    context->dynamicStringData = Clay__charArray_Allocate_Arena(Clay__ScaleCapacity(context, config->debugStringDataSize, reservedElementCount), arena);
+    Clay__SetEphemeralElementCapacity(context);
 }
 
 void Clay__InitializePersistentMemory(Clay_Context* context) {
     // Persistent memory - initialized once and not reset
-    int32_t maxElementCount = context->maxElementCount;
-    int32_t maxMeasureTextCacheWordCount = context->maxMeasureTextCacheWordCount;
+    Clay_MemoryConfig *config = &context->memoryConfig;
+    int32_t reservedElementCount = Clay__ReservedElementCount(context);
+    int32_t reservedMeasuredWordCount = Clay__ReservedMeasuredWordCount(context);
     Clay_Arena *arena = &context->internalArena;
 
-    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(100, arena);
-    context->transitionDatas = Clay__TransitionDataInternalArray_Allocate_Arena(200, arena);
-    context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->layoutElementsHashMapFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(maxElementCount, arena);
-    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(maxElementCount, arena);
-    context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(maxMeasureTextCacheWordCount, arena);
-    context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(maxElementCount, arena);
+    context->scrollContainerDatas = Clay__ScrollContainerDataInternalArray_Allocate_Arena(config->maxScrollContainerCount, arena);
+    context->scrollContainerDataBuckets = Clay__int32_tArray_Allocate_Arena(config->maxScrollContainerCount, arena);
+    context->transitionDatas = Clay__TransitionDataInternalArray_Allocate_Arena(config->maxTransitionCount, arena);
+    context->transitionDataBuckets = Clay__int32_tArray_Allocate_Arena(config->maxTransitionCount, arena);
+    context->layoutElementsHashMapInternal = Clay__LayoutElementHashMapItemArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxElementIdCount, reservedElementCount), arena);
+    context->layoutElementsHashMap = Clay__int32_tArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxElementIdCount, reservedElementCount), arena);
+    context->layoutElementsHashMapFreeList = Clay__int32_tArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxElementIdCount, reservedElementCount), arena);
+    context->measureTextHashMapInternal = Clay__MeasureTextCacheItemArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, reservedElementCount), arena);
+    context->measureTextHashMapInternalFreeList = Clay__int32_tArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxMeasureTextCacheEntryCount, reservedElementCount), arena);
+    context->measuredWordsFreeList = Clay__int32_tArray_Allocate_Arena(reservedMeasuredWordCount, arena);
+    // Bucket count is fixed at initialization, Clay_SetMaxMeasureTextCacheWordCount() only changes how many words are cached
+    context->measureTextHashMap = Clay__int32_tArray_Allocate_Arena(context->maxMeasureTextCacheWordCount / 32, arena);
+    context->measuredWords = Clay__MeasuredWordArray_Allocate_Arena(reservedMeasuredWordCount, arena);
+    context->pointerOverIds = Clay_ElementIdArray_Allocate_Arena(Clay__ScaleCapacity(context, config->maxPointerOverIdCount, reservedElementCount), arena);
+    context->cachedSizes = Clay__CachedSizeArray_Allocate_Arena(reservedElementCount, arena);
+    context->sizeCacheValid = false;
     context->arenaResetOffset = arena->nextAllocation;
+    Clay__SetPersistentElementCapacity(context);
+    context->measuredWords.capacity = context->maxMeasureTextCacheWordCount;
+    context->measuredWordsFreeList.capacity = context->maxMeasureTextCacheWordCount;
 }
 
 const float CLAY__EPSILON = 0.01;
@@ -2277,14 +3548,208 @@ Clay_SizingAxis Clay__GetElementSizing(Clay_LayoutElement* element, bool xAxis)
     }
 }
 
-// Writes out the location of text elements to layout elements buffer 1
-void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArray* textElementsOut, Clay__int32_tArray* aspectRatioElementsOut) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
-    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
-    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
-        bfsBuffer.length = 0;
-        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
+// Returns the size of the element along the axis, negated when shrinking so that both directions can be treated as growing
+float Clay__DistributionSize(Clay_LayoutElement *element, bool xAxis, bool shrink) {
+    float size = xAxis ? element->dimensions.width : element->dimensions.height;
+    return shrink ? -size : size;
+}
+
+// Returns the size the element stops growing at, i.e. its max size when growing and its negated min size when shrinking.
+// Only GROW containers are grown, which are never text elements, so the sizing is read without Clay__GetElementSizing.
+float Clay__DistributionLimit(Clay_LayoutElement *element, bool xAxis, bool shrink) {
+    if (shrink) {
+        return -(xAxis ? element->minDimensions.width : element->minDimensions.height);
+    }
+    return (xAxis ? element->config.layout.sizing.width : element->config.layout.sizing.height).size.minMax.max;
+}
+
+// Maps a float to a key whose unsigned integer order matches the order of the floats
+uint32_t Clay__FloatSortKey(float value) {
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    return (bits.u & 0x80000000) ? ~bits.u : bits.u | 0x80000000;
+}
+
+float Clay__FloatFromSortKey(uint32_t key) {
+    union { float f; uint32_t u; } bits;
+    bits.u = (key & 0x80000000) ? key & 0x7FFFFFFF : ~key;
+    return bits.f;
+}
+
+// Stable LSD radix sort of keys, one pass per byte, using buffer as scratch space. Bytes that are the same in every key are
+// skipped, which is common as siblings often share their sizes.
+void Clay__SortKeys(uint32_t *keys, uint32_t *buffer, int32_t length) {
+    bool sorted = true;
+    uint32_t differentBits = 0;
+    for (int32_t i = 1; i < length; ++i) {
+        sorted = sorted && keys[i - 1] <= keys[i];
+        differentBits |= keys[i] ^ keys[0];
+    }
+    if (sorted) {
+        return;
+    }
+    uint32_t *from = keys;
+    uint32_t *to = buffer;
+    for (int32_t shift = 0; shift < 32; shift += 8) {
+        if (((differentBits >> shift) & 0xFF) == 0) {
+            continue;
+        }
+        int32_t offsets[256] = CLAY__DEFAULT_STRUCT;
+        for (int32_t i = 0; i < length; ++i) {
+            offsets[(from[i] >> shift) & 0xFF]++;
+        }
+        int32_t total = 0;
+        for (int32_t bucket = 0; bucket < 256; ++bucket) {
+            int32_t count = offsets[bucket];
+            offsets[bucket] = total;
+            total += count;
+        }
+        for (int32_t i = 0; i < length; ++i) {
+            to[offsets[(from[i] >> shift) & 0xFF]++] = from[i];
+        }
+        uint32_t *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != keys) {
+        for (int32_t i = 0; i < length; ++i) {
+            keys[i] = from[i];
+        }
+    }
+}
+
+// The number of times Clay__DistributeSize scans the children for the next level before it sorts them instead
+#define CLAY__DISTRIBUTION_SCAN_LIMIT 8
+
+// Distributes sizeToDistribute between the resizable children by "water filling": the smallest children grow first until they
+// are level with the next smallest, and children stop once they reach their max size. When shrinking the largest children
+// shrink first down to their min size. Equivalent to repeatedly growing the smallest children, but the sizes and limits of the
+// children are copied into context->distributionKeys once and the level is raised over those. Siblings usually share a few
+// sizes, so the next level is found by scanning the copies, and only when that takes more than CLAY__DISTRIBUTION_SCAN_LIMIT
+// scans are they radix sorted so that the remaining levels are found in a single merge. Either way the cost is O(n).
+// Note: the distribution is exact, whereas the previous loop stopped with up to CLAY__EPSILON left over, so sizes differ from
+// the previous loop by about CLAY__EPSILON per level of nesting (tests/layout/distribute_size.c allows 1.5 times that). With
+// thousands of siblings the previous loop also lost space to float rounding and could stop making progress altogether.
+// A leftover of CLAY__EPSILON could restart position transitions of following siblings, so intermediate frames of transitions
+// can differ from the previous loop by a few pixels.
+void Clay__DistributeSize(Clay__int32_tArray *resizableContainerBuffer, bool xAxis, bool shrink, float sizeToDistribute) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    int32_t *children = resizableContainerBuffer->internalArray;
+    int32_t length = resizableContainerBuffer->length;
+    // Split into the sizes and limits of the children that can still grow, followed by scratch space for sorting
+    uint32_t *sizes = context->distributionKeys.internalArray;
+    uint32_t *limits = sizes + length;
+    uint32_t *sortBuffer = limits + length;
+    context->distributionKeys.length = length * 3;
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_DISTRIBUTION_KEYS, context->distributionKeys.length);
+    // Children that have already reached their limit are dropped, and the rest are moved to the front of the buffer
+    int32_t count = 0;
+    float level = CLAY__MAXFLOAT;
+    for (int32_t i = 0; i < length; ++i) {
+        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, children[i]);
+        float size = Clay__DistributionSize(child, xAxis, shrink);
+        float limit = Clay__DistributionLimit(child, xAxis, shrink);
+        if (limit > size) {
+            children[count] = children[i];
+            sizes[count] = Clay__FloatSortKey(size);
+            limits[count] = Clay__FloatSortKey(limit);
+            level = CLAY__MIN(level, size);
+            count++;
+        }
+    }
+    resizableContainerBuffer->length = count;
+
+    // Raise the level from the smallest child upwards. A child is active while the level is between its size and its limit,
+    // and the level rises through the sizes and limits above it until there is no space left to distribute.
+    bool settled = count == 0 || sizeToDistribute <= 0;
+    for (int32_t scan = 0; scan < CLAY__DISTRIBUTION_SCAN_LIMIT && !settled; ++scan) {
+        // The keys compare in the same order as the floats, so the scan doesn't need to convert them back
+        uint32_t levelKey = Clay__FloatSortKey(level);
+        uint32_t nextLevelKey = UINT32_MAX;
+        int32_t activeCount = 0;
+        for (int32_t i = 0; i < count; ++i) {
+            uint32_t key = sizes[i] > levelKey ? sizes[i] : limits[i];
+            activeCount += sizes[i] <= levelKey && limits[i] > levelKey;
+            nextLevelKey = key > levelKey ? CLAY__MIN(nextLevelKey, key) : nextLevelKey;
+        }
+        if (activeCount == 0) {
+            // Every child below the level has reached its limit, continue from the next smallest child if there is one
+            settled = nextLevelKey == UINT32_MAX;
+            level = settled ? level : Clay__FloatFromSortKey(nextLevelKey);
+            continue;
+        }
+        float nextLevel = Clay__FloatFromSortKey(nextLevelKey);
+        float sizeToNextLevel = (nextLevel - level) * (float)activeCount;
+        if (sizeToNextLevel >= sizeToDistribute) {
+            level += sizeToDistribute / (float)activeCount;
+            settled = true;
+        } else {
+            sizeToDistribute -= sizeToNextLevel;
+            level = nextLevel;
+        }
+    }
+
+    if (!settled) {
+        // A child's limit is always above its size, so the children whose limit is below the level are a subset of those whose
+        // size is, and the number of active children is the difference between the two.
+        Clay__SortKeys(sizes, sortBuffer, count);
+        Clay__SortKeys(limits, sortBuffer, count);
+        int32_t sizeIndex = 0;
+        int32_t limitIndex = 0;
+        while (sizeToDistribute > 0) {
+            while (sizeIndex < count && Clay__FloatFromSortKey(sizes[sizeIndex]) <= level) {
+                sizeIndex++;
+            }
+            // Children that have reached their limit stop growing
+            while (limitIndex < sizeIndex && Clay__FloatFromSortKey(limits[limitIndex]) <= level) {
+                limitIndex++;
+            }
+            int32_t activeCount = sizeIndex - limitIndex;
+            if (activeCount == 0) {
+                if (sizeIndex == count) {
+                    break;
+                }
+                level = Clay__FloatFromSortKey(sizes[sizeIndex]);
+                continue;
+            }
+            float nextLevel = Clay__FloatFromSortKey(limits[limitIndex]);
+            if (sizeIndex < count) {
+                nextLevel = CLAY__MIN(nextLevel, Clay__FloatFromSortKey(sizes[sizeIndex]));
+            }
+            float sizeToNextLevel = (nextLevel - level) * (float)activeCount;
+            if (sizeToNextLevel >= sizeToDistribute) {
+                level += sizeToDistribute / (float)activeCount;
+                break;
+            }
+            sizeToDistribute -= sizeToNextLevel;
+            level = nextLevel;
+        }
+    }
+
+    for (int32_t i = 0; i < count; ++i) {
+        Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, children[i]);
+        float size = Clay__DistributionSize(child, xAxis, shrink);
+        float newSize = CLAY__MAX(size, CLAY__MIN(level, Clay__DistributionLimit(child, xAxis, shrink)));
+        if (shrink) {
+            newSize = -newSize;
+        }
+        *(xAxis ? &child->dimensions.width : &child->dimensions.height) = newSize;
+    }
+}
+
+// Tests define CLAY__DISTRIBUTE_SIZE to run the layout pass with another distribution, see tests/layout/distribute_size.c
+#ifndef CLAY__DISTRIBUTE_SIZE
+#define CLAY__DISTRIBUTE_SIZE Clay__DistributeSize
+#endif
+
+// Writes out the location of text elements to layout elements buffer 1
+void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArray* textElementsOut, Clay__int32_tArray* aspectRatioElementsOut) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__int32_tArray bfsBuffer = context->layoutElementChildrenBuffer;
+    Clay__int32_tArray resizableContainerBuffer = context->openLayoutElementStack;
+    for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
+        bfsBuffer.length = 0;
+        Clay__LayoutElementTreeRoot *root = Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, rootIndex);
         Clay_LayoutElement *rootElement = Clay_LayoutElementArray_Get(&context->layoutElements, (int)root->layoutElementIndex);
         Clay__int32_tArray_Add(&bfsBuffer, (int32_t)root->layoutElementIndex);
 
@@ -2383,6 +3848,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArr
                 }
                 isFirstChild = false;
             }
+            Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK, resizableContainerBuffer.length);
 
             // Expand percentage containers to size
             for (int32_t childOffset = 0; childOffset < parent->children.length; childOffset++) {
@@ -2407,42 +3873,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArr
                     if (((xAxis && parent->config.clip.horizontal) || (!xAxis && parent->config.clip.vertical))) {
                         continue;
                     }
-                    // Scrolling containers preferentially compress before others
-                    while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float largest = 0;
-                        float secondLargest = 0;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, largest)) { continue; }
-                            if (childSize > largest) {
-                                secondLargest = largest;
-                                largest = childSize;
-                            }
-                            if (childSize < largest) {
-                                secondLargest = CLAY__MAX(secondLargest, childSize);
-                                widthToAdd = secondLargest - largest;
-                            }
-                        }
-
-                        widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            float minSize = xAxis ? child->minDimensions.width : child->minDimensions.height;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, largest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize <= minSize) {
-                                    *childSize = minSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
+                    CLAY__DISTRIBUTE_SIZE(&resizableContainerBuffer, xAxis, true, -sizeToDistribute);
                 // The content is too small, allow SIZING_GROW containers to expand
                 } else if (sizeToDistribute > 0 && growContainerCount > 0) {
                     for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
@@ -2452,42 +3883,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArr
                             Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
                         }
                     }
-                    while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer.length > 0) {
-                        float smallest = CLAY__MAXFLOAT;
-                        float secondSmallest = CLAY__MAXFLOAT;
-                        float widthToAdd = sizeToDistribute;
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float childSize = xAxis ? child->dimensions.width : child->dimensions.height;
-                            if (Clay__FloatEqual(childSize, smallest)) { continue; }
-                            if (childSize < smallest) {
-                                secondSmallest = smallest;
-                                smallest = childSize;
-                            }
-                            if (childSize > smallest) {
-                                secondSmallest = CLAY__MIN(secondSmallest, childSize);
-                                widthToAdd = secondSmallest - smallest;
-                            }
-                        }
-
-                        widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer.length);
-
-                        for (int childIndex = 0; childIndex < resizableContainerBuffer.length; childIndex++) {
-                            Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&resizableContainerBuffer, childIndex));
-                            float *childSize = xAxis ? &child->dimensions.width : &child->dimensions.height;
-                            Clay_SizingAxis childSizing = Clay__GetElementSizing(child, xAxis);
-                            float maxSize = childSizing.size.minMax.max;
-                            float previousWidth = *childSize;
-                            if (Clay__FloatEqual(*childSize, smallest)) {
-                                *childSize += widthToAdd;
-                                if (*childSize >= maxSize) {
-                                    *childSize = maxSize;
-                                    Clay__int32_tArray_RemoveSwapback(&resizableContainerBuffer, childIndex--);
-                                }
-                                sizeToDistribute -= (*childSize - previousWidth);
-                            }
-                        }
-                    }
+                    CLAY__DISTRIBUTE_SIZE(&resizableContainerBuffer, xAxis, false, sizeToDistribute);
                 }
             // Sizing along the non layout axis ("off axis")
             } else {
@@ -2509,6 +3905,7 @@ void Clay__SizeContainersAlongAxis(bool xAxis, float deltaTime, Clay__int32_tArr
                 }
             }
         }
+        Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER, bfsBuffer.length);
     }
 }
 
@@ -2517,6 +3914,10 @@ Clay_String Clay__IntToString(int32_t integer) {
         return CLAY__INIT(Clay_String) { .length = 1, .chars = "0" };
     }
     Clay_Context* context = Clay_GetCurrentContext();
+    // Enough space for the digits and sign of any int32_t
+    if (context->dynamicStringData.length + 11 > context->dynamicStringData.capacity) {
+        return CLAY__STRING_DEFAULT;
+    }
     char *chars = (char *)(context->dynamicStringData.internalArray + context->dynamicStringData.length);
     int32_t length = 0;
     int32_t sign = integer;
@@ -2543,10 +3944,108 @@ Clay_String Clay__IntToString(int32_t integer) {
     return CLAY__INIT(Clay_String) { .length = length, .chars = chars };
 }
 
+// Returns the array that render commands are currently written into
+Clay_RenderCommandArray *Clay__GetRenderCommandOutput(Clay_Context *context) {
+    return context->bufferedRenderCommands.internalArray ? &context->bufferedRenderCommands : &context->renderCommands;
+}
+
+void Clay__FlushRenderCommands(Clay_Context *context) {
+    Clay_RenderCommandArray *renderCommands = Clay__GetRenderCommandOutput(context);
+    if (context->renderCommandSink.flushFunction && renderCommands->length > 0) {
+        context->renderCommandSink.flushFunction(*renderCommands, context->renderCommandSink.userData);
+        context->flushedRenderCommandCount += renderCommands->length;
+        renderCommands->length = 0;
+    }
+}
+
+bool Clay__GrowRenderCommandBuffer(Clay_Context *context) {
+    Clay_RenderCommandArray *renderCommands = &context->bufferedRenderCommands;
+    if (!context->renderCommandBuffer.growFunction) {
+        return false;
+    }
+    int32_t capacity = renderCommands->capacity;
+    Clay_RenderCommand *memory = context->renderCommandBuffer.growFunction(renderCommands->internalArray, renderCommands->length, &capacity, context->renderCommandBuffer.userData);
+    if (!memory || capacity <= renderCommands->length) {
+        return false;
+    }
+    renderCommands->internalArray = memory;
+    renderCommands->capacity = capacity;
+    return true;
+}
+
+// Narrows clipRect to the parts of boundingBox along the axes that are clipped
+Clay_BoundingBox Clay__IntersectClipRect(Clay_BoundingBox clipRect, Clay_BoundingBox boundingBox, bool horizontal, bool vertical) {
+    if (horizontal) {
+        float right = CLAY__MIN(clipRect.x + clipRect.width, boundingBox.x + boundingBox.width);
+        clipRect.x = CLAY__MAX(clipRect.x, boundingBox.x);
+        clipRect.width = CLAY__MAX(right - clipRect.x, 0);
+    }
+    if (vertical) {
+        float bottom = CLAY__MIN(clipRect.y + clipRect.height, boundingBox.y + boundingBox.height);
+        clipRect.y = CLAY__MAX(clipRect.y, boundingBox.y);
+        clipRect.height = CLAY__MAX(bottom - clipRect.y, 0);
+    }
+    return clipRect;
+}
+
+#ifdef CLAY_RESOLVED_CLIP_RECTS
+void Clay__ResetRenderState(Clay_Context *context) {
+    context->renderState = CLAY__INIT(Clay__RenderState) { .clipRect = Clay__BoundingBox(0, 0, context->layoutDimensions.width, context->layoutDimensions.height) };
+}
+
+// Applies scissor and overlay commands to the current render state instead of emitting them, and copies the state into
+// every other command. Returns true if the command was consumed.
+bool Clay__ResolveRenderState(Clay_Context *context, Clay_RenderCommand *renderCommand) {
+    Clay__RenderState *state = &context->renderState;
+    switch (renderCommand->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+            state->clipRect = Clay__IntersectClipRect(state->clipRect, renderCommand->boundingBox, true, true);
+            return true;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START: {
+            // Overlaying a then b, mix(mix(color, a.rgb, a.a), b.rgb, b.a), is the same as a single overlay with the combined color below
+            Clay_Color a = state->overlayColor;
+            Clay_Color b = renderCommand->renderData.overlayColor.color;
+            float alpha = 1 - (1 - a.a / 255.0f) * (1 - b.a / 255.0f);
+            if (alpha > 0) {
+                float aWeight = (a.a / 255.0f) * (1 - b.a / 255.0f) / alpha;
+                float bWeight = (b.a / 255.0f) / alpha;
+                state->overlayColor = Clay__Color(a.r * aWeight + b.r * bWeight, a.g * aWeight + b.g * bWeight, a.b * aWeight + b.b * bWeight, alpha * 255);
+            }
+            return true;
+        }
+        // The state is restored from the tree node when the element that started it is closed
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_END: return true;
+        default: {
+            renderCommand->clipRect = state->clipRect;
+            renderCommand->overlayColor = state->overlayColor;
+            return false;
+        }
+    }
+}
+#endif
+
 void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
     Clay_Context* context = Clay_GetCurrentContext();
-    if (context->renderCommands.length < context->renderCommands.capacity - 1) {
-        Clay_RenderCommandArray_Add(&context->renderCommands, renderCommand);
+    CLAY__RESOLVE(if (Clay__ResolveRenderState(context, &renderCommand)) return);
+    Clay_RenderCommandArray *renderCommands = Clay__GetRenderCommandOutput(context);
+    // When streaming, a full array is handed to the sink rather than growing it
+    if (renderCommands->length >= renderCommands->capacity - 1) {
+        Clay__FlushRenderCommands(context);
+    }
+    if (renderCommands == &context->bufferedRenderCommands) {
+        if (renderCommands->length < renderCommands->capacity || Clay__GrowRenderCommandBuffer(context)) {
+            Clay_RenderCommandArray_Add(renderCommands, renderCommand);
+        } else if (!context->booleanWarnings.maxRenderCommandsExceeded) {
+            context->booleanWarnings.maxRenderCommandsExceeded = true;
+            context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+                .errorType = CLAY_ERROR_TYPE_ELEMENTS_CAPACITY_EXCEEDED,
+                .errorText = CLAY_STRING("Clay ran out of space in the buffer passed to Clay_SetRenderCommandBuffer() while attempting to create render commands. Try providing a larger buffer or a growFunction."),
+                .userData = context->errorHandler.userData });
+        }
+    } else if (renderCommands->length < renderCommands->capacity - 1 || Clay__GrowElementStorage(context)) {
+        Clay_RenderCommandArray_Add(renderCommands, renderCommand);
     } else {
         if (!context->booleanWarnings.maxRenderCommandsExceeded) {
             context->booleanWarnings.maxRenderCommandsExceeded = true;
@@ -2558,19 +4057,41 @@ void Clay__AddRenderCommand(Clay_RenderCommand renderCommand) {
     }
 }
 
-bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+bool Clay__ElementIsOutsideClip(Clay_BoundingBox *boundingBox, Clay_BoundingBox *clipRect) {
     Clay_Context* context = Clay_GetCurrentContext();
     if (context->disableCulling) {
         return false;
     }
 
-    return (boundingBox->x > (float)context->layoutDimensions.width) ||
-           (boundingBox->y > (float)context->layoutDimensions.height) ||
-           (boundingBox->x + boundingBox->width < 0) ||
-           (boundingBox->y + boundingBox->height < 0);
+    return (boundingBox->x > clipRect->x + clipRect->width) ||
+           (boundingBox->y > clipRect->y + clipRect->height) ||
+           (boundingBox->x + boundingBox->width < clipRect->x) ||
+           (boundingBox->y + boundingBox->height < clipRect->y);
+}
+
+bool Clay__ElementIsOffscreen(Clay_BoundingBox *boundingBox) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_BoundingBox windowRect = Clay__BoundingBox(0, 0, context->layoutDimensions.width, context->layoutDimensions.height);
+    return Clay__ElementIsOutsideClip(boundingBox, &windowRect);
+}
+
+// Nothing writes to wrappedTextLines before text is wrapped, so the lines from the previous frame are still in place
+// and only need to be rebased if the text they point into was passed to CLAY_TEXT from a different address this frame.
+void Clay__RestoreCachedWrappedLines(Clay_Context *context, Clay_LayoutElement *element, Clay__CachedSize *cachedSize) {
+    Clay__TextElementData *textElementData = &element->textElementData;
+    textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = cachedSize->wrappedLinesLength, .internalArray = &context->wrappedTextLines.internalArray[cachedSize->wrappedLinesIndex] };
+    if (cachedSize->textChars != textElementData->text.chars) {
+        for (int32_t lineIndex = 0; lineIndex < textElementData->wrappedLines.length; ++lineIndex) {
+            Clay_String *line = &textElementData->wrappedLines.internalArray[lineIndex].line;
+            line->chars = textElementData->text.chars + ((uintptr_t)line->chars - (uintptr_t)cachedSize->textChars);
+        }
+        cachedSize->textChars = textElementData->text.chars;
+    }
 }
 
-void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bool generateRenderCommands) {
+// If reuseWrappedText is true, the previous frame's sizes are in context->cachedSizes and its wrapped lines are still in
+// place, so text elements whose width didn't change keep their lines and new lines are added after the cached ones.
+void Clay__CalculateSizes(float deltaTime, bool reuseWrappedText) {
     Clay_Context* context = Clay_GetCurrentContext();
 
     // Calculate sizing along the X axis
@@ -2578,12 +4099,28 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
     textElements.length = 0;
     Clay__int32_tArray aspectRatioElements = context->reusableElementIndexBuffer;
     aspectRatioElements.length = 0;
+    uint64_t phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_SIZE_X);
     Clay__SizeContainersAlongAxis(true, deltaTime, &textElements, &aspectRatioElements);
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_CLIP_ELEMENT_STACK, textElements.length);
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER, aspectRatioElements.length);
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_SIZE_X, phaseStartTime);
 
     // Wrap text
+    phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_TEXT_WRAPPING);
+    if (reuseWrappedText) {
+        context->wrappedTextLines.length = context->cachedWrappedTextLineCount;
+    }
     for (int32_t textElementIndex = 0; textElementIndex < textElements.length; ++textElementIndex) {
         Clay_LayoutElement *element = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&textElements, textElementIndex));
         Clay__TextElementData *textElementData = &element->textElementData;
+        if (reuseWrappedText) {
+            Clay__CachedSize *cachedSize = Clay__CachedSizeArray_Get(&context->cachedSizes, Clay__int32_tArray_GetValue(&textElements, textElementIndex));
+            if (cachedSize->dimensions.width == element->dimensions.width) {
+                Clay__RestoreCachedWrappedLines(context, element, cachedSize);
+                element->dimensions.height = (element->textConfig.lineHeight > 0 ? (float)element->textConfig.lineHeight : textElementData->preferredDimensions.height) * (float)textElementData->wrappedLines.length;
+                continue;
+            }
+        }
         textElementData->wrappedLines = CLAY__INIT(Clay__WrappedTextLineArraySlice) { .length = 0, .internalArray = &context->wrappedTextLines.internalArray[context->wrappedTextLines.length] };
         Clay_LayoutElement *containerElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&textElements, textElementIndex));
         Clay__MeasureTextCacheItem *measureTextCacheItem = Clay__MeasureTextCached(&textElementData->text, &containerElement->textConfig);
@@ -2591,15 +4128,19 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
         float lineHeight = containerElement->textConfig.lineHeight > 0 ? (float)containerElement->textConfig.lineHeight : textElementData->preferredDimensions.height;
         int32_t lineLengthChars = 0;
         int32_t lineStartOffset = 0;
+        if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 2 && !Clay__GrowElementStorage(context)) {
+            continue;
+        }
         if (!measureTextCacheItem->containsNewlines && textElementData->preferredDimensions.width <= containerElement->dimensions.width) {
             Clay__WrappedTextLineArray_Add(&context->wrappedTextLines, CLAY__INIT(Clay__WrappedTextLine) { containerElement->dimensions,  textElementData->text });
             textElementData->wrappedLines.length++;
             continue;
         }
-        float spaceWidth = Clay__MeasureText(CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, &containerElement->textConfig, context->measureTextUserData).width;
+        float spaceWidth = Clay__CallMeasureText(context, CLAY__INIT(Clay_StringSlice) { .length = 1, .chars = CLAY__SPACECHAR.chars, .baseChars = CLAY__SPACECHAR.chars }, &containerElement->textConfig).width;
         int32_t wordIndex = measureTextCacheItem->measuredWordsStartIndex;
         while (wordIndex != -1) {
-            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 1) {
+            // Leave room for the final line
+            if (context->wrappedTextLines.length > context->wrappedTextLines.capacity - 2 && !Clay__GrowElementStorage(context)) {
                 break;
             }
             Clay__MeasuredWord *measuredWord = Clay__MeasuredWordArray_Get(&context->measuredWords, wordIndex);
@@ -2635,7 +4176,10 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
         containerElement->dimensions.height = lineHeight * (float)textElementData->wrappedLines.length;
     }
 
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_TEXT_WRAPPING, phaseStartTime);
+
     // Scale vertical heights according to aspect ratio
+    phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_PROPAGATE_HEIGHTS);
     for (int32_t i = 0; i < aspectRatioElements.length; ++i) {
         Clay_LayoutElement* aspectElement = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(&aspectRatioElements, i));
         aspectElement->dimensions.height = (1 / aspectElement->config.aspectRatio.aspectRatio) * aspectElement->dimensions.width;
@@ -2665,6 +4209,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                 context->treeNodeVisited.internalArray[dfsBuffer.length] = false;
                 Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]) });
             }
+            Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODES, dfsBuffer.length);
             continue;
         }
         dfsBuffer.length--;
@@ -2690,7 +4235,10 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
         }
     }
 
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_PROPAGATE_HEIGHTS, phaseStartTime);
+
     // Calculate sizing along the Y axis
+    phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_SIZE_Y);
     Clay__SizeContainersAlongAxis(false, deltaTime, NULL, NULL);
 
     // Scale horizontal widths according to aspect ratio
@@ -2699,23 +4247,105 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
         aspectElement->dimensions.width = aspectElement->config.aspectRatio.aspectRatio * aspectElement->dimensions.height;
     }
 
-    // Sort tree roots by z-index
-    int32_t sortMax = context->layoutElementTreeRoots.length - 1;
-    while (sortMax > 0) { // todo dumb bubble sort
-        for (int32_t i = 0; i < sortMax; ++i) {
-            Clay__LayoutElementTreeRoot current = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i);
-            Clay__LayoutElementTreeRoot next = *Clay__LayoutElementTreeRootArray_Get(&context->layoutElementTreeRoots, i + 1);
-            if (next.zIndex < current.zIndex) {
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i, next);
-                Clay__LayoutElementTreeRootArray_Set(&context->layoutElementTreeRoots, i + 1, current);
-            }
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_SIZE_Y, phaseStartTime);
+}
+
+void Clay__StoreCachedSizes(Clay_Context *context) {
+    context->cachedSizes.length = 0;
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[i];
+        Clay__CachedSize cachedSize = { .dimensions = element->dimensions };
+        if (element->isTextElement) {
+            cachedSize.textChars = element->textElementData.text.chars;
+            cachedSize.wrappedLinesIndex = (int32_t)(element->textElementData.wrappedLines.internalArray - context->wrappedTextLines.internalArray);
+            cachedSize.wrappedLinesLength = element->textElementData.wrappedLines.length;
         }
-        sortMax--;
+        Clay__CachedSizeArray_Add(&context->cachedSizes, cachedSize);
     }
+    context->cachedWrappedTextLineCount = context->wrappedTextLines.length;
+}
+
+void Clay__RestoreCachedSizes(Clay_Context *context) {
+    for (int32_t i = 0; i < context->layoutElements.length; ++i) {
+        Clay_LayoutElement *element = &context->layoutElements.internalArray[i];
+        Clay__CachedSize *cachedSize = &context->cachedSizes.internalArray[i];
+        element->dimensions = cachedSize->dimensions;
+        if (element->isTextElement) {
+            Clay__RestoreCachedWrappedLines(context, element, cachedSize);
+        }
+    }
+    context->wrappedTextLines.length = context->cachedWrappedTextLineCount;
+}
+
+// Frames that only change scroll offsets, colors or other properties that don't affect sizing produce the same sizing hash
+// as the previous frame, in which case the sizing and text wrapping phases are skipped and only final layout is recalculated.
+// If the root container was also resized, sizes are recalculated but text is only rewrapped where its width changed.
+// Rewrapped lines are added after the cached ones, so once they fill half of wrappedTextLines everything is rewrapped from the start.
+// Sizes are only stored once the hash has been stable for a frame, so layouts that change every frame don't pay to store them.
+void Clay__CalculateSizesWithCache(Clay_Context *context, float deltaTime, bool transitionsIdle) {
+    bool unchanged = transitionsIdle && context->retainedElementsLength == 0 && context->sizingHash == context->previousSizingHash;
+    bool cacheUsable = unchanged && context->sizeCacheValid && context->cachedSizes.length == context->layoutElements.length;
+    context->previousSizingHash = context->sizingHash;
+    Clay_Dimensions rootDimensions = context->layoutElements.internalArray[0].dimensions;
+    Clay_Dimensions cachedRootDimensions = context->cachedSizes.internalArray[0].dimensions;
+    if (cacheUsable && rootDimensions.width == cachedRootDimensions.width && rootDimensions.height == cachedRootDimensions.height) {
+        Clay__RestoreCachedSizes(context);
+        context->frameStats.sizesReused = true;
+        return;
+    }
+    Clay__CalculateSizes(deltaTime, cacheUsable && context->cachedWrappedTextLineCount <= context->wrappedTextLines.capacity / 2);
+    context->sizeCacheValid = unchanged;
+    if (unchanged) {
+        Clay__StoreCachedSizes(context);
+    }
+}
+
+// Stable LSD radix sort of the tree roots by zIndex, one pass per byte, so that roots with the same zIndex keep their declaration order.
+void Clay__SortLayoutElementTreeRoots(Clay_Context *context) {
+    Clay__LayoutElementTreeRootArray *roots = &context->layoutElementTreeRoots;
+    bool sorted = true;
+    for (int32_t i = 1; i < roots->length && sorted; ++i) {
+        sorted = roots->internalArray[i - 1].zIndex <= roots->internalArray[i].zIndex;
+    }
+    // Almost every frame only has the root element and a few floating elements that share a zIndex
+    if (sorted) {
+        return;
+    }
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_TREE_ROOTS_BUFFER, roots->length);
+    Clay__LayoutElementTreeRoot *from = roots->internalArray;
+    Clay__LayoutElementTreeRoot *to = context->layoutElementTreeRootsBuffer.internalArray;
+    for (int32_t shift = 0; shift < 16; shift += 8) {
+        int32_t offsets[256] = CLAY__DEFAULT_STRUCT;
+        for (int32_t i = 0; i < roots->length; ++i) {
+            // Flipping the sign bit orders negative zIndex values before positive ones
+            offsets[(((uint16_t)from[i].zIndex ^ 0x8000) >> shift) & 0xFF]++;
+        }
+        int32_t total = 0;
+        for (int32_t bucket = 0; bucket < 256; ++bucket) {
+            int32_t count = offsets[bucket];
+            offsets[bucket] = total;
+            total += count;
+        }
+        for (int32_t i = 0; i < roots->length; ++i) {
+            to[offsets[(((uint16_t)from[i].zIndex ^ 0x8000) >> shift) & 0xFF]++] = from[i];
+        }
+        Clay__LayoutElementTreeRoot *swap = from;
+        from = to;
+        to = swap;
+    }
+    // After an even number of passes the sorted roots are back in roots->internalArray
+}
+
+void Clay__CalculateFinalLayout(bool useStoredBoundingBoxes, bool generateRenderCommands) {
+    Clay_Context* context = Clay_GetCurrentContext();
+
+    // Sort tree roots by z-index
+    uint64_t phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_FINAL_LAYOUT);
+    Clay__SortLayoutElementTreeRoots(context);
 
     // Calculate final positions and generate render commands
-    context->renderCommands.length = 0;
-    dfsBuffer.length = 0;
+    Clay__GetRenderCommandOutput(context)->length = 0;
+    Clay__LayoutElementTreeNodeArray dfsBuffer = context->layoutElementTreeNodeArray1;
 
     for (int32_t rootIndex = 0; rootIndex < context->layoutElementTreeRoots.length; ++rootIndex) {
         dfsBuffer.length = 0;
@@ -2778,8 +4408,13 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
             targetAttachPosition.y += config->offset.y;
             rootPosition = targetAttachPosition;
         }
+        Clay_BoundingBox rootClipRect = Clay__BoundingBox(0, 0, context->layoutDimensions.width, context->layoutDimensions.height);
+        CLAY__RESOLVE(Clay__ResetRenderState(context));
         if (root->clipElementId) {
             Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
+            if (clipHashMapItem) {
+                rootClipRect = Clay__IntersectClipRect(rootClipRect, clipHashMapItem->boundingBox, true, true);
+            }
             if (clipHashMapItem && !Clay__ElementIsOffscreen(&clipHashMapItem->boundingBox)) {
                 // Floating elements that are attached to scrolling contents won't be correctly positioned if external scroll handling is enabled, fix here
                 if (context->externalScrollHandlingEnabled) {
@@ -2801,7 +4436,8 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                 }
             }
         }
-        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->config.layout.padding.left, .y = (float)rootElement->config.layout.padding.top } });
+        Clay__LayoutElementTreeNodeArray_Add(&dfsBuffer, CLAY__INIT(Clay__LayoutElementTreeNode) { .layoutElement = rootElement, .position = rootPosition, .nextChildOffset = { .x = (float)rootElement->config.layout.padding.left, .y = (float)rootElement->config.layout.padding.top }, .clipRect = rootClipRect });
+        CLAY__RESOLVE(dfsBuffer.internalArray[0].renderState = context->renderState);
 
         context->treeNodeVisited.internalArray[0] = false;
         while (dfsBuffer.length > 0) {
@@ -2809,6 +4445,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
             Clay_LayoutElement *currentElement = currentElementTreeNode->layoutElement;
             Clay_LayoutConfig *layoutConfig = currentElement->isTextElement ? &CLAY_LAYOUT_DEFAULT : &currentElement->config.layout;
             Clay_Vector2 scrollOffset = CLAY__DEFAULT_STRUCT;
+            CLAY__RESOLVE(context->renderState = currentElementTreeNode->renderState);
 
             // DFS is returning back upwards
             if (context->treeNodeVisited.internalArray[dfsBuffer.length - 1]) {
@@ -2817,19 +4454,16 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                     continue;
                 }
                 Clay_LayoutElementHashMapItem *currentElementData = Clay__GetHashMapItem(currentElement->id);
-                if (generateRenderCommands && !Clay__ElementIsOffscreen(&currentElementData->boundingBox)) {
+                if (generateRenderCommands && !Clay__ElementIsOutsideClip(&currentElementData->boundingBox, &currentElementTreeNode->clipRect)) {
                     // DFS is returning upwards backwards
                     bool closeClipElement = false;
                     if (currentElement->config.clip.horizontal || currentElement->config.clip.vertical) {
                         closeClipElement = true;
-                        for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                            Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                            if (mapping->layoutElement == currentElement) {
-                                scrollOffset = currentElement->config.clip.childOffset;
-                                if (context->externalScrollHandlingEnabled) {
-                                    scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                                }
-                                break;
+                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, currentElement->id);
+                        if (mapping && mapping->layoutElement == currentElement) {
+                            scrollOffset = currentElement->config.clip.childOffset;
+                            if (context->externalScrollHandlingEnabled) {
+                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
                             }
                         }
                     }
@@ -2846,6 +4480,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                             }},
                             .userData = currentElement->config.userData,
                             .id = Clay__HashNumber(currentElement->id, currentElement->children.length).id,
+                            .zIndex = root->zIndex,
                             .commandType = CLAY_RENDER_COMMAND_TYPE_BORDER,
                         };
                         Clay__AddRenderCommand(renderCommand);
@@ -2858,12 +4493,13 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                                     Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
                                     if (i > 0) {
                                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                                .boundingBox = { currentElementBoundingBox.x + borderOffset.x + scrollOffset.x - halfWidth, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->width.betweenChildren, currentElement->dimensions.height },
+                                                .boundingBox = Clay__BoundingBox(currentElementBoundingBox.x + borderOffset.x + scrollOffset.x - halfWidth, currentElementBoundingBox.y + scrollOffset.y, (float)borderConfig->width.betweenChildren, currentElement->dimensions.height),
                                                 .renderData = { .rectangle = {
                                                         .backgroundColor = borderConfig->color,
                                                 } },
                                                 .userData = currentElement->config.userData,
                                                 .id = Clay__HashNumber(currentElement->id, currentElement->children.length + 1 + i).id,
+                                                .zIndex = root->zIndex,
                                                 .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
                                         });
                                     }
@@ -2874,12 +4510,13 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                                     Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
                                     if (i > 0) {
                                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                                                .boundingBox = { currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y - halfWidth, currentElement->dimensions.width, (float)borderConfig->width.betweenChildren },
+                                                .boundingBox = Clay__BoundingBox(currentElementBoundingBox.x + scrollOffset.x, currentElementBoundingBox.y + borderOffset.y + scrollOffset.y - halfWidth, currentElement->dimensions.width, (float)borderConfig->width.betweenChildren),
                                                 .renderData = { .rectangle = {
                                                         .backgroundColor = borderConfig->color,
                                                 } },
                                                 .userData = currentElement->config.userData,
                                                 .id = Clay__HashNumber(currentElement->id, currentElement->children.length + 1 + i).id,
+                                                .zIndex = root->zIndex,
                                                 .commandType = CLAY_RENDER_COMMAND_TYPE_RECTANGLE,
                                         });
                                     }
@@ -2901,6 +4538,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                     if (closeClipElement) {
                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
                                 .id = Clay__HashNumber(currentElement->id, rootElement->children.length + 11).id,
+                                .zIndex = root->zIndex,
                                 .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END,
                         });
                     }
@@ -2912,26 +4550,19 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
 
             // This will only be run a single time for each element in downwards DFS order
             context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = true;
-            Clay_BoundingBox currentElementBoundingBox = { currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height };
+            Clay_BoundingBox currentElementBoundingBox = Clay__BoundingBox(currentElementTreeNode->position.x, currentElementTreeNode->position.y, currentElement->dimensions.width, currentElement->dimensions.height);
             Clay__ScrollContainerDataInternal *scrollContainerData = CLAY__NULL;
             if (!currentElement->isTextElement) {
                 if (useStoredBoundingBoxes && currentElement->config.transition.handler) {
-                    bool found = false;
-                    for (int j = 0; j < context->transitionDatas.length; ++j) {
-                        Clay__TransitionDataInternal* transitionData = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, j);
-                        if (transitionData->elementId == currentElement->id) {
-                            found = true;
-                            if (transitionData->state != CLAY_TRANSITION_STATE_IDLE) {
-                                if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_X) != 0) currentElementBoundingBox.x = transitionData->currentState.boundingBox.x;
-                                if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_Y) != 0) currentElementBoundingBox.y = transitionData->currentState.boundingBox.y;
-                                if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_WIDTH) != 0) currentElementBoundingBox.width = transitionData->currentState.boundingBox.width;
-                                if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_HEIGHT) != 0) currentElementBoundingBox.height = transitionData->currentState.boundingBox.height;
-                            }
-                            break;
-                        }
+                    Clay__TransitionDataInternal* transitionData = Clay__TransitionDataInternalArray_Find(&context->transitionDatas, &context->transitionDataBuckets, currentElement->id);
+                    if (transitionData && transitionData->state != CLAY_TRANSITION_STATE_IDLE) {
+                        if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_X) != 0) currentElementBoundingBox.x = transitionData->currentState.boundingBox.x;
+                        if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_Y) != 0) currentElementBoundingBox.y = transitionData->currentState.boundingBox.y;
+                        if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_WIDTH) != 0) currentElementBoundingBox.width = transitionData->currentState.boundingBox.width;
+                        if ((transitionData->activeProperties & CLAY_TRANSITION_PROPERTY_HEIGHT) != 0) currentElementBoundingBox.height = transitionData->currentState.boundingBox.height;
                     }
                     // An exiting element that completed its transition this frame - skip tree
-                    if (!found && currentElement->config.transition.exit.setFinalState) {
+                    if (!transitionData && currentElement->config.transition.exit.setFinalState) {
                         dfsBuffer.length--;
                         continue;
                     }
@@ -2947,23 +4578,19 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
 
                 // Apply scroll offsets to container
                 if (currentElement->config.clip.horizontal || currentElement->config.clip.vertical) {
-                    // This linear scan could theoretically be slow under very strange conditions, but I can't imagine a real UI with more than a few 10's of scroll containers
-                    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-                        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-                        if (mapping->layoutElement == currentElement) {
-                            scrollContainerData = mapping;
-                            mapping->boundingBox = currentElementBoundingBox;
-                            scrollOffset = currentElement->config.clip.childOffset;
-                            if (context->externalScrollHandlingEnabled) {
-                                scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
-                            }
-                            break;
+                    Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, currentElement->id);
+                    if (mapping && mapping->layoutElement == currentElement) {
+                        scrollContainerData = mapping;
+                        mapping->boundingBox = currentElementBoundingBox;
+                        scrollOffset = currentElement->config.clip.childOffset;
+                        if (context->externalScrollHandlingEnabled) {
+                            scrollOffset = CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
                         }
                     }
                 }
             }
 
-            bool offscreen = Clay__ElementIsOffscreen(&currentElementBoundingBox);
+            bool offscreen = Clay__ElementIsOutsideClip(&currentElementBoundingBox, &currentElementTreeNode->clipRect);
 
             // Generate render commands for current element
             if (generateRenderCommands && !offscreen) {
@@ -2973,9 +4600,11 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                     float finalLineHeight = textElementConfig->lineHeight > 0 ? (float)textElementConfig->lineHeight : naturalLineHeight;
                     float lineHeightOffset = (finalLineHeight - naturalLineHeight) / 2;
                     float yPosition = lineHeightOffset;
+                    Clay_BoundingBox *clipRect = &currentElementTreeNode->clipRect;
                     for (int32_t lineIndex = 0; lineIndex < currentElement->textElementData.wrappedLines.length; ++lineIndex) {
                         Clay__WrappedTextLine *wrappedLine = Clay__WrappedTextLineArraySlice_Get(&currentElement->textElementData.wrappedLines, lineIndex);
-                        if (wrappedLine->line.length == 0) {
+                        // Skip lines that have been scrolled above the top of the clip rect
+                        if (wrappedLine->line.length == 0 || (!context->disableCulling && currentElementBoundingBox.y + yPosition + finalLineHeight < clipRect->y)) {
                             yPosition += finalLineHeight;
                             continue;
                         }
@@ -2987,7 +4616,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                             offset /= 2;
                         }
                         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) {
-                            .boundingBox = { currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height },
+                            .boundingBox = Clay__BoundingBox(currentElementBoundingBox.x + offset, currentElementBoundingBox.y + yPosition, wrappedLine->dimensions.width, wrappedLine->dimensions.height),
                             .renderData = { .text = {
                                 .stringContents = CLAY__INIT(Clay_StringSlice) { .length = wrappedLine->line.length, .chars = wrappedLine->line.chars, .baseChars = currentElement->textElementData.text.chars },
                                 .textColor = textElementConfig->textColor,
@@ -3003,7 +4632,7 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                         });
                         yPosition += finalLineHeight;
 
-                        if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > context->layoutDimensions.height)) {
+                        if (!context->disableCulling && (currentElementBoundingBox.y + yPosition > clipRect->y + clipRect->height)) {
                             break;
                         }
                     }
@@ -3134,8 +4763,18 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                 scrollContainerData->contentSize = CLAY__INIT(Clay_Dimensions) {contentSizeCurrent.width + (float)(layoutConfig->padding.left + layoutConfig->padding.right), contentSizeCurrent.height + (float)(layoutConfig->padding.top + layoutConfig->padding.bottom) };
             }
 
+            CLAY__RESOLVE(currentElementTreeNode->renderState = context->renderState);
+
+            // Children are culled against the clip rect of this element. It only narrows at clip containers, because children
+            // of other elements can overflow them and still be visible even when this element itself was culled.
+            Clay_BoundingBox childClipRect = currentElementTreeNode->clipRect;
+            if (currentElement->config.clip.horizontal || currentElement->config.clip.vertical) {
+                childClipRect = Clay__IntersectClipRect(childClipRect, currentElementBoundingBox, currentElement->config.clip.horizontal, currentElement->config.clip.vertical);
+            }
+
             // Add children to the DFS buffer
             dfsBuffer.length += currentElement->children.length;
+            Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODES, dfsBuffer.length);
             for (int32_t i = 0; i < currentElement->children.length; ++i) {
                 Clay_LayoutElement *childElement = Clay_LayoutElementArray_Get(&context->layoutElements, currentElement->children.elements[i]);
                 Clay_LayoutElementHashMapItem* childMapItem = Clay__GetHashMapItem(childElement->id);
@@ -3169,7 +4808,9 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
                     .layoutElement = childElement,
                     .position = CLAY__INIT(Clay_Vector2) { childPosition.x, childPosition.y },
                     .nextChildOffset = { .x = (float)childElement->config.layout.padding.left, .y = (float)childElement->config.layout.padding.top },
+                    .clipRect = childClipRect,
                 };
+                CLAY__RESOLVE(dfsBuffer.internalArray[newNodeIndex].renderState = context->renderState);
                 context->treeNodeVisited.internalArray[newNodeIndex] = false;
 
                 // Update parent offsets
@@ -3183,13 +4824,17 @@ void Clay__CalculateFinalLayout(float deltaTime, bool useStoredBoundingBoxes, bo
             }
         }
 
-        if (root->clipElementId) {
+        if (root->clipElementId && generateRenderCommands) {
             Clay_LayoutElementHashMapItem *clipHashMapItem = Clay__GetHashMapItem(root->clipElementId);
             if (clipHashMapItem && !Clay__ElementIsOffscreen(&clipHashMapItem->boundingBox)) {
-                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->children.length + 11).id, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
+                Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand) { .id = Clay__HashNumber(rootElement->id, rootElement->children.length + 11).id, .zIndex = root->zIndex, .commandType = CLAY_RENDER_COMMAND_TYPE_SCISSOR_END });
             }
         }
+        if (generateRenderCommands) {
+            Clay__FlushRenderCommands(context);
+        }
     }
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_FINAL_LAYOUT, phaseStartTime);
 }
 
 CLAY_WASM_EXPORT("Clay_GetPointerOverIds")
@@ -3418,6 +5063,7 @@ Clay__RenderDebugLayoutData Clay__RenderDebugLayoutElementsList(int32_t initialR
                     Clay__int32_tArray_Add(&dfsBuffer, currentElement->children.elements[i]);
                     context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
                 }
+                Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER, dfsBuffer.length);
             }
         }
     }
@@ -3540,15 +5186,12 @@ void Clay__RenderDebugView(void) {
     Clay_ElementId scrollId = Clay__HashString(CLAY_STRING("Clay__DebugViewOuterScrollPane"), 0);
     float scrollYOffset = 0;
     bool pointerInDebugView = context->pointerInfo.position.y < context->layoutDimensions.height - 300;
-    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-        if (scrollContainerData->elementId == scrollId.id) {
-            if (!context->externalScrollHandlingEnabled) {
-                scrollYOffset = scrollContainerData->scrollPosition.y;
-            } else {
-                pointerInDebugView = context->pointerInfo.position.y + scrollContainerData->scrollPosition.y < context->layoutDimensions.height - 300;
-            }
-            break;
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, scrollId.id);
+    if (scrollContainerData) {
+        if (!context->externalScrollHandlingEnabled) {
+            scrollYOffset = scrollContainerData->scrollPosition.y;
+        } else {
+            pointerInDebugView = context->pointerInfo.position.y + scrollContainerData->scrollPosition.y < context->layoutDimensions.height - 300;
         }
     }
     int32_t highlightedRow = pointerInDebugView
@@ -3953,7 +5596,7 @@ uint32_t Clay__debugViewWidth = 400;
 Clay_Color Clay__debugViewHighlightColor = { 168, 66, 28, 100 };
 
 Clay__WarningArray Clay__WarningArray_Allocate_Arena(int32_t capacity, Clay_Arena *arena) {
-    size_t totalSizeBytes = capacity * sizeof(Clay_String);
+    size_t totalSizeBytes = capacity * sizeof(Clay__Warning);
     Clay__WarningArray array = {.capacity = capacity, .length = 0};
     uintptr_t nextAllocOffset = arena->nextAllocation + (64 - (arena->nextAllocation % 64));
     if (nextAllocOffset + totalSizeBytes <= arena->capacity) {
@@ -4025,24 +5668,41 @@ bool Clay__Array_AddCapacityCheck(int32_t length, int32_t capacity)
 
 CLAY_WASM_EXPORT("Clay_MinMemorySize")
 uint32_t Clay_MinMemorySize(void) {
+    return (uint32_t)Clay_PlanMemory(CLAY__INIT(Clay_MemoryConfig) CLAY__DEFAULT_STRUCT).arenaCapacityBytes;
+}
+
+CLAY_WASM_EXPORT("Clay_PlanMemory")
+Clay_MemoryPlan Clay_PlanMemory(Clay_MemoryConfig memoryConfig) {
+    memoryConfig = Clay__ResolveMemoryConfig(memoryConfig);
     Clay_Context fakeContext = {
-        .maxElementCount = Clay__defaultMaxElementCount,
-        .maxMeasureTextCacheWordCount = Clay__defaultMaxMeasureTextWordCacheCount,
+        .maxElementCount = memoryConfig.maxElementCount,
+        .maxMeasureTextCacheWordCount = memoryConfig.maxMeasureTextCacheWordCount,
         .internalArena = {
             .capacity = SIZE_MAX,
             .memory = NULL,
-        }
+        },
+        .memoryConfig = memoryConfig,
     };
-    Clay_Context* currentContext = Clay_GetCurrentContext();
-    if (currentContext) {
-        fakeContext.maxElementCount = currentContext->maxElementCount;
-        fakeContext.maxMeasureTextCacheWordCount = currentContext->maxMeasureTextCacheWordCount;
-    }
     // Reserve space in the arena for the context, important for calculating min memory size correctly
     Clay__Context_Allocate_Arena(&fakeContext.internalArena);
     Clay__InitializePersistentMemory(&fakeContext);
     Clay__InitializeEphemeralMemory(&fakeContext);
-    return (uint32_t)fakeContext.internalArena.nextAllocation + 128;
+    Clay_MemoryPlan plan = CLAY__DEFAULT_STRUCT;
+    plan.contextBytes = sizeof(Clay_Context);
+    plan.arenaCapacityBytes = (size_t)fakeContext.internalArena.nextAllocation + 128;
+    plan.committedBytes = plan.contextBytes;
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        Clay__MemoryArrayInfo info = Clay__GetMemoryArrayInfo(&fakeContext, (Clay_MemoryArrayType)i);
+        plan.arrays[i] = CLAY__INIT(Clay_MemoryArrayPlan) {
+            .name = info.name,
+            .capacity = info.capacity,
+            .itemSize = info.itemSize,
+            .bytes = (size_t)info.capacity * info.itemSize,
+            .reservedBytes = (size_t)info.reservedCapacity * info.itemSize,
+        };
+        plan.committedBytes += plan.arrays[i].bytes;
+    }
+    return plan;
 }
 
 CLAY_WASM_EXPORT("Clay_CreateArenaWithCapacityAndMemory")
@@ -4059,6 +5719,7 @@ void Clay_SetMeasureTextFunction(Clay_Dimensions (*measureTextFunction)(Clay_Str
     Clay_Context* context = Clay_GetCurrentContext();
     Clay__MeasureText = measureTextFunction;
     context->measureTextUserData = userData;
+    context->sizeCacheValid = false;
 }
 void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)(uint32_t elementId, void *userData), void *userData) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4070,6 +5731,12 @@ void Clay_SetQueryScrollOffsetFunction(Clay_Vector2 (*queryScrollOffsetFunction)
 CLAY_WASM_EXPORT("Clay_SetLayoutDimensions")
 void Clay_SetLayoutDimensions(Clay_Dimensions dimensions) {
     Clay_Context* context = Clay_GetCurrentContext();
+    #ifdef CLAY_RECORDING
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_LAYOUT_DIMENSIONS)) {
+        Clay__RecordFloat(context, dimensions.width);
+        Clay__RecordFloat(context, dimensions.height);
+    }
+    #endif
     context->rootResizedLastFrame = !Clay__FloatEqual(context->layoutDimensions.width, dimensions.width) || !Clay__FloatEqual(context->layoutDimensions.height, dimensions.height);
     context->layoutDimensions = dimensions;
 }
@@ -4083,9 +5750,17 @@ Clay_Dimensions Clay_GetLayoutDimensions() {
 CLAY_WASM_EXPORT("Clay_SetPointerState")
 void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
     Clay_Context* context = Clay_GetCurrentContext();
+    #ifdef CLAY_RECORDING
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_POINTER_STATE)) {
+        Clay__RecordFloat(context, position.x);
+        Clay__RecordFloat(context, position.y);
+        Clay__RecordUInt8(context, (uint8_t)isPointerDown);
+    }
+    #endif
     if (context->booleanWarnings.maxElementsExceeded) {
         return;
     }
+    uint64_t phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_POINTER_HIT_TESTING);
     context->pointerInfo.position = position;
     context->pointerOverIds.length = 0;
     Clay__int32_tArray dfsBuffer = context->layoutElementChildrenBuffer;
@@ -4111,17 +5786,15 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
             if (mapItem && mapItem->generation > context->generation) {
                 // Conditionally skip mouse interactions on non-exit transitions, based on user config
                 if (!currentElement->isTextElement && currentElement->config.transition.handler) {
-                    for (int I = 0; I < context->transitionDatas.length; ++I) {
-                        Clay__TransitionDataInternal* data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, I);
-                        if (data->elementId == currentElement->id) {
-                            if (currentElement->config.transition.interactionHandling == CLAY_TRANSITION_DISABLE_INTERACTIONS_WHILE_TRANSITIONING_POSITION) {
-                                if (data->state == CLAY_TRANSITION_STATE_EXITING || data->state == CLAY_TRANSITION_STATE_ENTERING || ((data->activeProperties & CLAY_TRANSITION_PROPERTY_POSITION) && data->state == CLAY_TRANSITION_STATE_TRANSITIONING)) {
-                                    skipTree = true;
-                                }
-                            } else if (currentElement->config.transition.interactionHandling == CLAY_TRANSITION_ALLOW_INTERACTIONS_WHILE_TRANSITIONING_POSITION) {
-                                if (data->state == CLAY_TRANSITION_STATE_EXITING) {
-                                    skipTree = true;
-                                }
+                    Clay__TransitionDataInternal* data = Clay__TransitionDataInternalArray_Find(&context->transitionDatas, &context->transitionDataBuckets, currentElement->id);
+                    if (data) {
+                        if (currentElement->config.transition.interactionHandling == CLAY_TRANSITION_DISABLE_INTERACTIONS_WHILE_TRANSITIONING_POSITION) {
+                            if (data->state == CLAY_TRANSITION_STATE_EXITING || data->state == CLAY_TRANSITION_STATE_ENTERING || ((data->activeProperties & CLAY_TRANSITION_PROPERTY_POSITION) && data->state == CLAY_TRANSITION_STATE_TRANSITIONING)) {
+                                skipTree = true;
+                            }
+                        } else if (currentElement->config.transition.interactionHandling == CLAY_TRANSITION_ALLOW_INTERACTIONS_WHILE_TRANSITIONING_POSITION) {
+                            if (data->state == CLAY_TRANSITION_STATE_EXITING) {
+                                skipTree = true;
                             }
                         }
                     }
@@ -4138,9 +5811,13 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
                 if ((Clay__PointIsInsideRect(position, elementBox)) && (clipElementId == 0 || (Clay__PointIsInsideRect(position, clipItem->boundingBox)) || context->externalScrollHandlingEnabled)) {
                     if (!skipTree) {
                         if (mapItem->onHoverFunction) {
+                            CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, CLAY_STRING("OnHover"), CLAY_STRING("id"), mapItem->elementId.id);
                             mapItem->onHoverFunction(mapItem->elementId, context->pointerInfo, mapItem->hoverFunctionUserData);
+                            CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, CLAY_STRING("OnHover"), CLAY__STRING_DEFAULT, 0);
+                        }
+                        if (context->pointerOverIds.length < context->pointerOverIds.capacity) {
+                            Clay_ElementIdArray_Add(&context->pointerOverIds, mapItem->elementId);
                         }
-                        Clay_ElementIdArray_Add(&context->pointerOverIds, mapItem->elementId);
                     }
                     found = true;
                 }
@@ -4149,6 +5826,7 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
                     Clay__int32_tArray_Add(&dfsBuffer, currentElement->children.elements[i]);
                     context->treeNodeVisited.internalArray[dfsBuffer.length - 1] = false; // TODO needs to be ranged checked
                 }
+                Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER, dfsBuffer.length);
             } else {
                 dfsBuffer.length--;
             }
@@ -4173,6 +5851,7 @@ void Clay_SetPointerState(Clay_Vector2 position, bool isPointerDown) {
             context->pointerInfo.state = CLAY_POINTER_DATA_RELEASED_THIS_FRAME;
         }
     }
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_POINTER_HIT_TESTING, phaseStartTime);
 }
 
 CLAY_WASM_EXPORT("Clay_GetPointerState")
@@ -4182,24 +5861,53 @@ CLAY_DLL_EXPORT Clay_PointerData Clay_GetPointerState(void) {
 
 CLAY_WASM_EXPORT("Clay_Initialize")
 Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler) {
+    return Clay_InitializeWithMemoryConfig(arena, layoutDimensions, errorHandler, CLAY__INIT(Clay_MemoryConfig) CLAY__DEFAULT_STRUCT);
+}
+
+CLAY_WASM_EXPORT("Clay_ReservedMemorySize")
+size_t Clay_ReservedMemorySize(Clay_ArenaGrowthConfig growthConfig) {
+    Clay_MemoryConfig memoryConfig = CLAY__DEFAULT_STRUCT;
+    memoryConfig.growth = growthConfig;
+    return Clay_PlanMemory(memoryConfig).arenaCapacityBytes;
+}
+
+CLAY_WASM_EXPORT("Clay_InitializeGrowable")
+Clay_Context* Clay_InitializeGrowable(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler, Clay_ArenaGrowthConfig growthConfig) {
+    Clay_MemoryConfig memoryConfig = CLAY__DEFAULT_STRUCT;
+    memoryConfig.growth = growthConfig;
+    return Clay_InitializeWithMemoryConfig(arena, layoutDimensions, errorHandler, memoryConfig);
+}
+
+CLAY_WASM_EXPORT("Clay_InitializeWithMemoryConfig")
+Clay_Context* Clay_InitializeWithMemoryConfig(Clay_Arena arena, Clay_Dimensions layoutDimensions, Clay_ErrorHandler errorHandler, Clay_MemoryConfig memoryConfig) {
     // Cacheline align memory passed in
     uintptr_t baseOffset = 64 - ((uintptr_t)arena.memory % 64);
     baseOffset = baseOffset == 64 ? 0 : baseOffset;
     arena.memory += baseOffset;
+    Clay_ArenaGrowthConfig *growth = &memoryConfig.growth;
+    if (growth->commitMemoryFunction && sizeof(Clay_Context) <= arena.capacity && !growth->commitMemoryFunction(arena.memory, sizeof(Clay_Context), growth->userData)) {
+        return NULL;
+    }
     Clay_Context *context = Clay__Context_Allocate_Arena(&arena);
     if (context == NULL) return NULL;
     // DEFAULTS
     Clay_Context *oldContext = Clay_GetCurrentContext();
+    memoryConfig = Clay__ResolveMemoryConfig(memoryConfig);
     *context = CLAY__INIT(Clay_Context) {
-        .maxElementCount = oldContext ? oldContext->maxElementCount : Clay__defaultMaxElementCount,
-        .maxMeasureTextCacheWordCount = oldContext ? oldContext->maxMeasureTextCacheWordCount : Clay__defaultMaxMeasureTextWordCacheCount,
+        .maxElementCount = memoryConfig.maxElementCount,
+        .maxMeasureTextCacheWordCount = memoryConfig.maxMeasureTextCacheWordCount,
         .errorHandler = errorHandler.errorHandlerFunction ? errorHandler : CLAY__INIT(Clay_ErrorHandler) { Clay__ErrorHandlerFunctionDefault, 0 },
         .layoutDimensions = layoutDimensions,
         .internalArena = arena,
+        .memoryConfig = memoryConfig,
     };
     Clay_SetCurrentContext(context);
     Clay__InitializePersistentMemory(context);
     Clay__InitializeEphemeralMemory(context);
+    if (!Clay__CommitInitialStorage(context)) {
+        Clay_SetCurrentContext(oldContext);
+        return NULL;
+    }
     for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
         context->layoutElementsHashMap.internalArray[i] = -1;
     }
@@ -4207,6 +5915,12 @@ Clay_Context* Clay_Initialize(Clay_Arena arena, Clay_Dimensions layoutDimensions
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    for (int32_t i = 0; i < context->scrollContainerDataBuckets.capacity; ++i) {
+        context->scrollContainerDataBuckets.internalArray[i] = -1;
+    }
+    for (int32_t i = 0; i < context->transitionDataBuckets.capacity; ++i) {
+        context->transitionDataBuckets.internalArray[i] = -1;
+    }
     context->layoutDimensions = layoutDimensions;
     return context;
 }
@@ -4228,11 +5942,9 @@ Clay_Vector2 Clay_GetScrollOffset(void) {
         return CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
     }
     Clay_LayoutElement *openLayoutElement = Clay__GetOpenLayoutElement();
-    for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
-        Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-        if (mapping->elementId == openLayoutElement->id) {
-            return mapping->scrollPosition;
-        }
+    Clay__ScrollContainerDataInternal *mapping = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, openLayoutElement->id);
+    if (mapping) {
+        return mapping->scrollPosition;
     }
     return CLAY__INIT(Clay_Vector2) CLAY__DEFAULT_STRUCT;
 }
@@ -4240,6 +5952,14 @@ Clay_Vector2 Clay_GetScrollOffset(void) {
 CLAY_WASM_EXPORT("Clay_UpdateScrollContainers")
 void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDelta, float deltaTime) {
     Clay_Context* context = Clay_GetCurrentContext();
+    #ifdef CLAY_RECORDING
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_UPDATE_SCROLL_CONTAINERS)) {
+        Clay__RecordUInt8(context, (uint8_t)enableDragScrolling);
+        Clay__RecordFloat(context, scrollDelta.x);
+        Clay__RecordFloat(context, scrollDelta.y);
+        Clay__RecordFloat(context, deltaTime);
+    }
+    #endif
     bool isPointerActive = enableDragScrolling && (context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED || context->pointerInfo.state == CLAY_POINTER_DATA_PRESSED_THIS_FRAME);
     // Don't apply scroll events to ancestors of the inner element
     int32_t highestPriorityElementIndex = -1;
@@ -4247,14 +5967,14 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
     for (int32_t i = 0; i < context->scrollContainerDatas.length; i++) {
         Clay__ScrollContainerDataInternal *scrollData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
         if (!scrollData->openThisFrame) {
-            Clay__ScrollContainerDataInternalArray_RemoveSwapback(&context->scrollContainerDatas, i);
+            Clay__ScrollContainerDataInternalArray_Remove(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, i);
             continue;
         }
         scrollData->openThisFrame = false;
         Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(scrollData->elementId);
         // Element isn't rendered this frame but scroll offset has been retained
         if (!hashMapItem) {
-            Clay__ScrollContainerDataInternalArray_RemoveSwapback(&context->scrollContainerDatas, i);
+            Clay__ScrollContainerDataInternalArray_Remove(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, i);
             continue;
         }
 
@@ -4351,10 +6071,86 @@ void Clay_UpdateScrollContainers(bool enableDragScrolling, Clay_Vector2 scrollDe
     }
 }
 
+bool Clay__ElementIsRetained(Clay_Context *context, Clay_LayoutElement *element) {
+    return element > context->layoutElements.internalArray && element <= context->layoutElements.internalArray + context->retainedElementsLength;
+}
+
+void Clay__MoveRetainedElement(Clay_Context *context, int32_t fromIndex, int32_t toIndex) {
+    Clay_LayoutElementArray_Set_DontTouchLength(&context->layoutElements, toIndex, *Clay_LayoutElementArray_GetCheckCapacity(&context->layoutElements, fromIndex));
+    Clay__StringArray_Set_DontTouchLength(&context->layoutElementIdStrings, toIndex, *Clay__StringArray_GetCheckCapacity(&context->layoutElementIdStrings, fromIndex));
+    Clay__int32_tArray_Set_DontTouchLength(&context->layoutElementClipElementIds, toIndex, *Clay__int32_tArray_GetCheckCapacity(&context->layoutElementClipElementIds, fromIndex));
+}
+
+// Subtrees of exiting elements live in a region directly after the root container, which survives the ephemeral memory reset.
+// A subtree is moved into the region once when its exit transition starts, and is then referenced in place every frame
+// until the transition completes. The region is only rebuilt when the set of exiting elements changes.
+void Clay__RetainExitingElements(Clay_Context *context) {
+    int32_t exitingCount = 0;
+    bool changed = false;
+    for (int32_t i = 0; i < context->transitionDatas.length; ++i) {
+        Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
+        if (data->state == CLAY_TRANSITION_STATE_EXITING) {
+            exitingCount++;
+            changed |= !Clay__ElementIsRetained(context, data->elementThisFrame);
+        }
+    }
+    if (!changed && exitingCount == context->retainedSubtreeCount) {
+        return;
+    }
+
+    // Subtrees are compacted towards the front in order of their current position, which is always at or after
+    // their destination. Both the subtrees and their children are laid out in breadth first order, so copying
+    // them in the same order never overwrites an element or child slot that hasn't been read yet.
+    Clay__int32_tArray exitingTransitions = context->reusableElementIndexBuffer;
+    exitingTransitions.length = 0;
+    for (int32_t i = 0; i < context->transitionDatas.length; ++i) {
+        Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
+        if (data->state == CLAY_TRANSITION_STATE_EXITING) {
+            int32_t j = exitingTransitions.length;
+            Clay__int32_tArray_Add(&exitingTransitions, i);
+            while (j > 0 && Clay__TransitionDataInternalArray_Get(&context->transitionDatas, exitingTransitions.internalArray[j - 1])->elementThisFrame > data->elementThisFrame) {
+                exitingTransitions.internalArray[j] = exitingTransitions.internalArray[j - 1];
+                j--;
+            }
+            exitingTransitions.internalArray[j] = i;
+        }
+    }
+    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER, exitingTransitions.length);
+
+    Clay__int32_tArray bfsBuffer = context->openLayoutElementStack;
+    int32_t nextIndex = 1;
+    int32_t nextChildIndex = 0;
+    for (int32_t i = 0; i < exitingTransitions.length; ++i) {
+        Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, exitingTransitions.internalArray[i]);
+        bfsBuffer.length = 0;
+        Clay__MoveRetainedElement(context, (int32_t)(data->elementThisFrame - context->layoutElements.internalArray), nextIndex);
+        data->elementThisFrame = Clay_LayoutElementArray_GetCheckCapacity(&context->layoutElements, nextIndex);
+        Clay__int32_tArray_Add(&bfsBuffer, nextIndex++);
+        for (int32_t bufferIndex = 0; bufferIndex < bfsBuffer.length; ++bufferIndex) {
+            Clay_LayoutElement *layoutElement = Clay_LayoutElementArray_GetCheckCapacity(&context->layoutElements, Clay__int32_tArray_GetValue(&bfsBuffer, bufferIndex));
+            int32_t *previousChildren = layoutElement->children.elements;
+            layoutElement->children.elements = &context->layoutElementChildren.internalArray[nextChildIndex];
+            for (int32_t j = 0; j < layoutElement->children.length; ++j) {
+                Clay__MoveRetainedElement(context, previousChildren[j], nextIndex);
+                Clay__int32_tArray_Set_DontTouchLength(&context->layoutElementChildren, nextChildIndex++, nextIndex);
+                Clay__int32_tArray_Add(&bfsBuffer, nextIndex++);
+            }
+        }
+        Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK, bfsBuffer.length);
+    }
+    context->retainedElementsLength = nextIndex - 1;
+    context->retainedElementChildrenLength = nextChildIndex;
+    context->retainedSubtreeCount = exitingTransitions.length;
+}
+
 CLAY_WASM_EXPORT("Clay_BeginLayout")
 void Clay_BeginLayout(void) {
     Clay_Context* context = Clay_GetCurrentContext();
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, CLAY_STRING("Frame"), CLAY__STRING_DEFAULT, 0);
+    CLAY__RECORD(Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_BEGIN_LAYOUT));
+    context->declarationStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_DECLARATION);
     Clay__InitializeEphemeralMemory(context);
+    Clay__RetainExitingElements(context);
     context->generation++;
     context->dynamicElementIndex = 0;
     // Set up the root container that covers the entire window
@@ -4363,12 +6159,22 @@ void Clay_BeginLayout(void) {
         rootDimensions.width -= (float)Clay__debugViewWidth;
     }
     context->booleanWarnings = CLAY__INIT(Clay_BooleanWarnings) CLAY__DEFAULT_STRUCT;
+    context->sizingHash = 14695981039346656037ULL;
+    context->flushedRenderCommandCount = 0;
+    CLAY__RESOLVE(Clay__ResetRenderState(context));
+    context->layoutElementChildren.length = context->retainedElementChildrenLength;
     Clay__OpenElementWithId(CLAY_ID("Clay__RootContainer"));
+    // Elements declared this frame are placed after the retained exiting subtrees
+    context->layoutElements.length += context->retainedElementsLength;
+    context->layoutElementIdStrings.length += context->retainedElementsLength;
+    context->layoutElementClipElementIds.length += context->retainedElementsLength;
     Clay__ConfigureOpenElement(CLAY__INIT(Clay_ElementDeclaration) {
         .layout = { .sizing = {CLAY_SIZING_FIXED((rootDimensions.width)), CLAY_SIZING_FIXED(rootDimensions.height)} }
     });
     Clay__int32_tArray_Add(&context->openLayoutElementStack, 0);
     Clay__LayoutElementTreeRootArray_Add(&context->layoutElementTreeRoots, CLAY__INIT(Clay__LayoutElementTreeRoot) { .layoutElementIndex = 0 });
+    // Only record elements declared by the user, not the root container or the debug view
+    CLAY__RECORD(context->recordingDeclarations = true);
 }
 
 void Clay__CloneElementsWithExitTransition() {
@@ -4378,12 +6184,13 @@ void Clay__CloneElementsWithExitTransition() {
 
     for (int i = 0; i < context->transitionDatas.length; ++i) {
         Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
-        Clay_TransitionElementConfig* config = &data->elementThisFrame->config.transition;
-        if (data->transitionOut) {
+        // Exiting subtrees are retained in place, see Clay__RetainExitingElements()
+        if (data->transitionOut && data->state != CLAY_TRANSITION_STATE_EXITING) {
             Clay__int32_tArray bfsBuffer = context->openLayoutElementStack;
             bfsBuffer.length = 0;
             Clay_LayoutElement* newElement = Clay_LayoutElementArray_Set_DontTouchLength(&context->layoutElements, nextIndex, *data->elementThisFrame);
             Clay__StringArray_Set_DontTouchLength(&context->layoutElementIdStrings, nextIndex, *Clay__StringArray_GetCheckCapacity(&context->layoutElementIdStrings, data->elementThisFrame - context->layoutElements.internalArray));
+            Clay__int32_tArray_Set_DontTouchLength(&context->layoutElementClipElementIds, nextIndex, *Clay__int32_tArray_GetCheckCapacity(&context->layoutElementClipElementIds, data->elementThisFrame - context->layoutElements.internalArray));
             Clay__int32_tArray_Add(&bfsBuffer, nextIndex);
             data->elementThisFrame = newElement;
             nextIndex--;
@@ -4397,21 +6204,25 @@ void Clay__CloneElementsWithExitTransition() {
                     Clay__int32_tArray_Add(&bfsBuffer, nextIndex);
                     Clay_LayoutElement* newChildElement = Clay_LayoutElementArray_Set_DontTouchLength(&context->layoutElements, nextIndex, *childElement);
                     Clay__StringArray_Set_DontTouchLength(&context->layoutElementIdStrings, nextIndex, *Clay__StringArray_GetCheckCapacity(&context->layoutElementIdStrings, childElement - context->layoutElements.internalArray));
+                    Clay__int32_tArray_Set_DontTouchLength(&context->layoutElementClipElementIds, nextIndex, *Clay__int32_tArray_GetCheckCapacity(&context->layoutElementClipElementIds, childElement - context->layoutElements.internalArray));
                     Clay__int32_tArray_Set_DontTouchLength(&context->layoutElementChildren, nextChildIndex, nextIndex);
                     nextIndex--;
                     nextChildIndex--;
                 }
                 layoutElement->children.elements = &context->layoutElementChildren.internalArray[nextChildIndex + 1];
             }
+            Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK, bfsBuffer.length);
         }
     }
+    context->exitingElementsLength = context->layoutElements.capacity - 1 - nextIndex;
+    context->exitingElementsChildrenLength = context->layoutElementChildren.capacity - 1 - nextChildIndex;
 };
 
 void Clay_ApplyTransitionedPropertiesToElement(Clay_LayoutElement* currentElement, Clay_TransitionProperty properties, Clay_TransitionData currentTransitionData, Clay_BoundingBox* boundingBox, bool reparented) {
     if (properties & CLAY_TRANSITION_PROPERTY_WIDTH) {
         if (!reparented) {
             currentElement->dimensions.width = currentTransitionData.boundingBox.width;
-            currentElement->config.layout.sizing.width = CLAY_SIZING_FIXED(currentTransitionData.boundingBox.width);
+            currentElement->config.layout.sizing.width = CLAY_SIZING_FIXED((float)currentTransitionData.boundingBox.width);
         } else {
             boundingBox->width = currentTransitionData.boundingBox.width;
         }
@@ -4419,7 +6230,7 @@ void Clay_ApplyTransitionedPropertiesToElement(Clay_LayoutElement* currentElemen
     if (properties & CLAY_TRANSITION_PROPERTY_HEIGHT) {
         if (!reparented) {
             currentElement->dimensions.height = currentTransitionData.boundingBox.height;
-            currentElement->config.layout.sizing.height = CLAY_SIZING_FIXED(currentTransitionData.boundingBox.height);
+            currentElement->config.layout.sizing.height = CLAY_SIZING_FIXED((float)currentTransitionData.boundingBox.height);
         } else {
             boundingBox->height = currentTransitionData.boundingBox.height;
         }
@@ -4444,32 +6255,273 @@ void Clay_ApplyTransitionedPropertiesToElement(Clay_LayoutElement* currentElemen
     }
 }
 
-CLAY_WASM_EXPORT("Clay_EndLayout")
-Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
-    Clay_Context* context = Clay_GetCurrentContext();
-    Clay__CloseElement();
-
-    if (context->openLayoutElementStack.length > 1) {
-        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
-            .errorType = CLAY_ERROR_TYPE_UNBALANCED_OPEN_CLOSE,
-            .errorText = CLAY_STRING("There were still open layout elements when EndLayout was called. This results from an unequal number of calls to Clay__OpenElement and Clay__CloseElement."),
-            .userData = context->errorHandler.userData });
-    }
+// Width and height transitions of elements that haven't been reparented are applied through their sizing, which affects the layout of their siblings and parents
+bool Clay__TransitionResizesElement(Clay_TransitionProperty properties, bool reparented) {
+    return !reparented && (properties & (CLAY_TRANSITION_PROPERTY_WIDTH | CLAY_TRANSITION_PROPERTY_HEIGHT)) != 0;
+}
 
-    // Prune non exiting transitions
-    for (int i = 0; i < context->transitionDatas.length; ++i) {
-        Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
-        Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(data->elementId);
-        // Transition element exited and doesn't have an exit handler defined
-        // Or, the user deleted the transition handler from one frame to the next
-        if (!data->transitionOut && (hashMapItem->generation <= context->generation || !hashMapItem->layoutElement->config.transition.handler)) {
-            Clay__TransitionDataInternalArray_RemoveSwapback(&context->transitionDatas, i);
-            i--;
-            continue;
+// Applies the state calculated by a transition handler to the element, and returns true if the transition has finished exiting and should be removed
+bool Clay__ApplyTransitionStep(Clay__TransitionDataInternal *transitionData, bool transitionComplete, float deltaTime, bool *transitionsApplied, bool *transitionsResized) {
+    Clay_LayoutElementHashMapItem* mapItem = Clay__GetHashMapItem(transitionData->elementId);
+    Clay_ApplyTransitionedPropertiesToElement(transitionData->elementThisFrame, transitionData->activeProperties, transitionData->currentState, &mapItem->boundingBox, transitionData->reparented);
+    *transitionsApplied = true;
+    *transitionsResized |= Clay__TransitionResizesElement(transitionData->activeProperties, transitionData->reparented);
+    transitionData->elapsedTime += deltaTime;
+
+    if (transitionComplete) {
+        if (transitionData->state == CLAY_TRANSITION_STATE_ENTERING || transitionData->state == CLAY_TRANSITION_STATE_TRANSITIONING) {
+            transitionData->state = CLAY_TRANSITION_STATE_IDLE;
+            transitionData->elapsedTime = 0;
+            transitionData->reparented = false;
+            transitionData->activeProperties = CLAY_TRANSITION_PROPERTY_NONE;
+        } else if (transitionData->state == CLAY_TRANSITION_STATE_EXITING) {
+            return true;
         }
     }
+    return false;
+}
 
-    for (int i = 0; i < context->transitionDatas.length; ++i) {
+// Built in transition curves are evaluated four at a time, using SIMD on supported platforms
+#if !defined(CLAY_DISABLE_SIMD) && (defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64))
+typedef __m128 Clay__SIMDFloat4;
+static inline Clay__SIMDFloat4 Clay__SIMDLoad(const float *values) { return _mm_loadu_ps(values); }
+static inline void Clay__SIMDStore(float *values, Clay__SIMDFloat4 a) { _mm_storeu_ps(values, a); }
+static inline Clay__SIMDFloat4 Clay__SIMDSet(float value) { return _mm_set1_ps(value); }
+static inline Clay__SIMDFloat4 Clay__SIMDAdd(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return _mm_add_ps(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDSub(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return _mm_sub_ps(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDMul(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return _mm_mul_ps(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDDiv(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return _mm_div_ps(a, b); }
+#elif !defined(CLAY_DISABLE_SIMD) && defined(__aarch64__)
+typedef float32x4_t Clay__SIMDFloat4;
+static inline Clay__SIMDFloat4 Clay__SIMDLoad(const float *values) { return vld1q_f32(values); }
+static inline void Clay__SIMDStore(float *values, Clay__SIMDFloat4 a) { vst1q_f32(values, a); }
+static inline Clay__SIMDFloat4 Clay__SIMDSet(float value) { return vdupq_n_f32(value); }
+static inline Clay__SIMDFloat4 Clay__SIMDAdd(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return vaddq_f32(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDSub(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return vsubq_f32(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDMul(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return vmulq_f32(a, b); }
+static inline Clay__SIMDFloat4 Clay__SIMDDiv(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { return vdivq_f32(a, b); }
+#else
+typedef struct { float lanes[4]; } Clay__SIMDFloat4;
+static inline Clay__SIMDFloat4 Clay__SIMDLoad(const float *values) { Clay__SIMDFloat4 r; for (int i = 0; i < 4; ++i) r.lanes[i] = values[i]; return r; }
+static inline void Clay__SIMDStore(float *values, Clay__SIMDFloat4 a) { for (int i = 0; i < 4; ++i) values[i] = a.lanes[i]; }
+static inline Clay__SIMDFloat4 Clay__SIMDSet(float value) { Clay__SIMDFloat4 r; for (int i = 0; i < 4; ++i) r.lanes[i] = value; return r; }
+static inline Clay__SIMDFloat4 Clay__SIMDAdd(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] += b.lanes[i]; return a; }
+static inline Clay__SIMDFloat4 Clay__SIMDSub(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] -= b.lanes[i]; return a; }
+static inline Clay__SIMDFloat4 Clay__SIMDMul(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] *= b.lanes[i]; return a; }
+static inline Clay__SIMDFloat4 Clay__SIMDDiv(Clay__SIMDFloat4 a, Clay__SIMDFloat4 b) { for (int i = 0; i < 4; ++i) a.lanes[i] /= b.lanes[i]; return a; }
+#endif
+
+typedef enum {
+    CLAY__TRANSITION_CURVE_NONE,
+    CLAY__TRANSITION_CURVE_EASE_OUT,
+    CLAY__TRANSITION_CURVE_EASE_IN_OUT,
+    CLAY__TRANSITION_CURVE_SPRING,
+    CLAY__TRANSITION_CURVE_COUNT,
+} Clay__TransitionCurve;
+
+#define CLAY__TRANSITION_BATCH_SIZE 64
+#define CLAY__SPRING_STIFFNESS 10.0f
+
+Clay__TransitionCurve Clay__GetTransitionCurve(bool (*handler)(Clay_TransitionCallbackArguments arguments)) {
+    if (handler == Clay_EaseOut) return CLAY__TRANSITION_CURVE_EASE_OUT;
+    if (handler == Clay_EaseInOut) return CLAY__TRANSITION_CURVE_EASE_IN_OUT;
+    if (handler == Clay_Spring) return CLAY__TRANSITION_CURVE_SPRING;
+    return CLAY__TRANSITION_CURVE_NONE;
+}
+
+float Clay__TransitionRatio(float elapsedTime, float duration) {
+    return duration > 0 ? CLAY__MIN(elapsedTime / duration, 1) : 1;
+}
+
+// Critically damped spring 1 - (1 + x)e^-x, where e^-x is approximated by (1 - x/256)^256
+static inline Clay__SIMDFloat4 Clay__SIMDSpring(Clay__SIMDFloat4 x) {
+    Clay__SIMDFloat4 one = Clay__SIMDSet(1);
+    Clay__SIMDFloat4 decay = Clay__SIMDSub(one, Clay__SIMDMul(x, Clay__SIMDSet(1.0f / 256)));
+    for (int i = 0; i < 8; ++i) {
+        decay = Clay__SIMDMul(decay, decay);
+    }
+    return Clay__SIMDSub(one, Clay__SIMDMul(Clay__SIMDAdd(one, x), decay));
+}
+
+// Maps each ratio of elapsed time to duration in [0, 1] to the amount to interpolate between the initial and target states
+void Clay__EvaluateTransitionCurve(Clay__TransitionCurve curve, const float *ratios, float *lerpAmounts, int32_t count) {
+    Clay__SIMDFloat4 one = Clay__SIMDSet(1);
+    for (int32_t i = 0; i < count; i += 4) {
+        float lanes[4] = { 1, 1, 1, 1 };
+        for (int32_t j = 0; j < 4 && i + j < count; ++j) {
+            lanes[j] = ratios[i + j];
+        }
+        Clay__SIMDFloat4 t = Clay__SIMDLoad(lanes);
+        Clay__SIMDFloat4 result = t;
+        switch (curve) {
+            case CLAY__TRANSITION_CURVE_EASE_OUT: {
+                Clay__SIMDFloat4 inverse = Clay__SIMDSub(one, t);
+                result = Clay__SIMDSub(one, Clay__SIMDMul(Clay__SIMDMul(inverse, inverse), inverse));
+                break;
+            }
+            // cubic-bezier(0.42, 0, 0.58, 1). The bezier parameter is solved from x with Newton's method, which converges
+            // quickly here as the slope of x is always at least 0.87
+            case CLAY__TRANSITION_CURVE_EASE_IN_OUT: {
+                Clay__SIMDFloat4 s = t;
+                for (int iteration = 0; iteration < 4; ++iteration) {
+                    Clay__SIMDFloat4 x = Clay__SIMDMul(Clay__SIMDAdd(Clay__SIMDMul(Clay__SIMDAdd(Clay__SIMDMul(Clay__SIMDSet(0.52f), s), Clay__SIMDSet(-0.78f)), s), Clay__SIMDSet(1.26f)), s);
+                    Clay__SIMDFloat4 slope = Clay__SIMDAdd(Clay__SIMDMul(Clay__SIMDAdd(Clay__SIMDMul(Clay__SIMDSet(1.56f), s), Clay__SIMDSet(-1.56f)), s), Clay__SIMDSet(1.26f));
+                    s = Clay__SIMDSub(s, Clay__SIMDDiv(Clay__SIMDSub(x, t), slope));
+                }
+                result = Clay__SIMDMul(Clay__SIMDMul(s, s), Clay__SIMDSub(Clay__SIMDSet(3), Clay__SIMDMul(Clay__SIMDSet(2), s)));
+                break;
+            }
+            // Normalised so that the spring lands exactly on the target at the end of the duration
+            case CLAY__TRANSITION_CURVE_SPRING: {
+                Clay__SIMDFloat4 stiffness = Clay__SIMDSet(CLAY__SPRING_STIFFNESS);
+                result = Clay__SIMDDiv(Clay__SIMDSpring(Clay__SIMDMul(t, stiffness)), Clay__SIMDSpring(stiffness));
+                break;
+            }
+            default: break;
+        }
+        Clay__SIMDStore(lanes, result);
+        for (int32_t j = 0; j < 4 && i + j < count; ++j) {
+            lerpAmounts[i + j] = lanes[j];
+        }
+    }
+}
+
+// CLAY_COMPACT stores colors and bounding boxes as integers, so they are widened to floats for interpolation and rounded afterwards
+Clay__SIMDFloat4 Clay__SIMDLoadColor(const Clay_Color *color) {
+    #ifdef CLAY_COMPACT
+    float values[4] = { (float)color->r, (float)color->g, (float)color->b, (float)color->a };
+    return Clay__SIMDLoad(values);
+    #else
+    return Clay__SIMDLoad(&color->r);
+    #endif
+}
+
+void Clay__SIMDStoreColor(Clay_Color *color, Clay__SIMDFloat4 value) {
+    #ifdef CLAY_COMPACT
+    float values[4];
+    Clay__SIMDStore(values, value);
+    *color = Clay__Color(values[0], values[1], values[2], values[3]);
+    #else
+    Clay__SIMDStore(&color->r, value);
+    #endif
+}
+
+Clay__SIMDFloat4 Clay__SIMDLoadBoundingBox(const Clay_BoundingBox *boundingBox) {
+    #ifdef CLAY_COMPACT
+    float values[4] = { (float)boundingBox->x, (float)boundingBox->y, (float)boundingBox->width, (float)boundingBox->height };
+    return Clay__SIMDLoad(values);
+    #else
+    return Clay__SIMDLoad(&boundingBox->x);
+    #endif
+}
+
+// Interpolates each property group of the transition data as a single four lane operation
+void Clay__LerpTransitionData(Clay_TransitionData *current, const Clay_TransitionData *initial, const Clay_TransitionData *target, Clay_TransitionProperty properties, float lerpAmount) {
+    Clay__SIMDFloat4 mix = Clay__SIMDSet(lerpAmount);
+    #define CLAY__LERP_FLOAT4(load, field) Clay__SIMDAdd(load(&initial->field), Clay__SIMDMul(Clay__SIMDSub(load(&target->field), load(&initial->field)), mix))
+    if (properties & CLAY_TRANSITION_PROPERTY_BOUNDING_BOX) {
+        float boundingBox[4];
+        Clay__SIMDStore(boundingBox, CLAY__LERP_FLOAT4(Clay__SIMDLoadBoundingBox, boundingBox));
+        if (properties & CLAY_TRANSITION_PROPERTY_X) current->boundingBox.x = Clay__RoundCoordinate(boundingBox[0]);
+        if (properties & CLAY_TRANSITION_PROPERTY_Y) current->boundingBox.y = Clay__RoundCoordinate(boundingBox[1]);
+        if (properties & CLAY_TRANSITION_PROPERTY_WIDTH) current->boundingBox.width = Clay__RoundCoordinate(boundingBox[2]);
+        if (properties & CLAY_TRANSITION_PROPERTY_HEIGHT) current->boundingBox.height = Clay__RoundCoordinate(boundingBox[3]);
+    }
+    if (properties & CLAY_TRANSITION_PROPERTY_BACKGROUND_COLOR) {
+        Clay__SIMDStoreColor(&current->backgroundColor, CLAY__LERP_FLOAT4(Clay__SIMDLoadColor, backgroundColor));
+    }
+    if (properties & CLAY_TRANSITION_PROPERTY_OVERLAY_COLOR) {
+        Clay__SIMDStoreColor(&current->overlayColor, CLAY__LERP_FLOAT4(Clay__SIMDLoadColor, overlayColor));
+    }
+    if (properties & CLAY_TRANSITION_PROPERTY_BORDER_COLOR) {
+        Clay__SIMDStoreColor(&current->borderColor, CLAY__LERP_FLOAT4(Clay__SIMDLoadColor, borderColor));
+    }
+    #undef CLAY__LERP_FLOAT4
+    if (properties & CLAY_TRANSITION_PROPERTY_BORDER_WIDTH) {
+        current->borderWidth = CLAY__INIT(Clay_BorderWidth) {
+            .left = (uint16_t)(initial->borderWidth.left + (target->borderWidth.left - initial->borderWidth.left) * lerpAmount),
+            .right = (uint16_t)(initial->borderWidth.right + (target->borderWidth.right - initial->borderWidth.right) * lerpAmount),
+            .top = (uint16_t)(initial->borderWidth.top + (target->borderWidth.top - initial->borderWidth.top) * lerpAmount),
+            .bottom = (uint16_t)(initial->borderWidth.bottom + (target->borderWidth.bottom - initial->borderWidth.bottom) * lerpAmount),
+            .betweenChildren = (uint16_t)(initial->borderWidth.betweenChildren + (target->borderWidth.betweenChildren - initial->borderWidth.betweenChildren) * lerpAmount),
+        };
+    }
+}
+
+// Evaluates the pending transitions that use one of the built in curves together, CLAY__TRANSITION_BATCH_SIZE at a time, instead of
+// calling their handlers individually. Finished exit transitions are marked by negating their index, as removing them here would
+// move transitions that haven't been updated yet.
+void Clay__EvaluateBatchedTransitions(Clay_Context *context, Clay__int32_tArray *batchedTransitions, int32_t *firstPendingTransition, float deltaTime, bool *transitionsApplied, bool *transitionsResized) {
+    float ratios[CLAY__TRANSITION_BATCH_SIZE];
+    float lerpAmounts[CLAY__TRANSITION_BATCH_SIZE];
+    int32_t batchIndices[CLAY__TRANSITION_BATCH_SIZE];
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, CLAY_STRING("TransitionBatch"), CLAY_STRING("count"), batchedTransitions->length - *firstPendingTransition);
+    for (int32_t curve = CLAY__TRANSITION_CURVE_EASE_OUT; curve < CLAY__TRANSITION_CURVE_COUNT; ++curve) {
+        int32_t batchLength = 0;
+        for (int32_t i = *firstPendingTransition; i <= batchedTransitions->length; ++i) {
+            if (i < batchedTransitions->length && batchedTransitions->internalArray[i] >= 0) {
+                Clay__TransitionDataInternal *transitionData = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, batchedTransitions->internalArray[i]);
+                Clay_TransitionElementConfig *config = &transitionData->elementThisFrame->config.transition;
+                if (Clay__GetTransitionCurve(config->handler) == (Clay__TransitionCurve)curve) {
+                    ratios[batchLength] = Clay__TransitionRatio(transitionData->elapsedTime, config->duration);
+                    batchIndices[batchLength++] = i;
+                }
+            }
+            if (batchLength == CLAY__TRANSITION_BATCH_SIZE || (i == batchedTransitions->length && batchLength > 0)) {
+                Clay__EvaluateTransitionCurve((Clay__TransitionCurve)curve, ratios, lerpAmounts, batchLength);
+                for (int32_t j = 0; j < batchLength; ++j) {
+                    int32_t *transitionIndex = &batchedTransitions->internalArray[batchIndices[j]];
+                    Clay__TransitionDataInternal *transitionData = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, *transitionIndex);
+                    Clay__LerpTransitionData(&transitionData->currentState, &transitionData->initialState, &transitionData->targetState, transitionData->activeProperties, lerpAmounts[j]);
+                    transitionData->evaluationPending = false;
+                    if (Clay__ApplyTransitionStep(transitionData, ratios[j] >= 1, deltaTime, transitionsApplied, transitionsResized)) {
+                        *transitionIndex = -1 - *transitionIndex;
+                    }
+                }
+                batchLength = 0;
+            }
+        }
+    }
+    *firstPendingTransition = batchedTransitions->length;
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, CLAY_STRING("TransitionBatch"), CLAY__STRING_DEFAULT, 0);
+}
+
+CLAY_WASM_EXPORT("Clay_EndLayout")
+Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    #ifdef CLAY_RECORDING
+    context->recordingDeclarations = false;
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_END_LAYOUT)) {
+        Clay__RecordFloat(context, deltaTime);
+    }
+    #endif
+    Clay__CloseElement();
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_DECLARATION, context->declarationStartTime);
+
+    if (context->openLayoutElementStack.length > 1) {
+        context->errorHandler.errorHandlerFunction(CLAY__INIT(Clay_ErrorData) {
+            .errorType = CLAY_ERROR_TYPE_UNBALANCED_OPEN_CLOSE,
+            .errorText = CLAY_STRING("There were still open layout elements when EndLayout was called. This results from an unequal number of calls to Clay__OpenElement and Clay__CloseElement."),
+            .userData = context->errorHandler.userData });
+    }
+
+    // Prune non exiting transitions
+    uint64_t phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING);
+    for (int i = 0; i < context->transitionDatas.length; ++i) {
+        Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
+        Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(data->elementId);
+        // Transition element exited and doesn't have an exit handler defined
+        // Or, the user deleted the transition handler from one frame to the next
+        if (!data->transitionOut && (hashMapItem->generation <= context->generation || !hashMapItem->layoutElement->config.transition.handler)) {
+            Clay__TransitionDataInternalArray_Remove(&context->transitionDatas, &context->transitionDataBuckets, i);
+            i--;
+            continue;
+        }
+    }
+
+    // Exiting subtrees are cloned back from the end of the element arrays, make sure there's room for all of them
+    Clay__EnsureElementCapacity(context, CLAY__MAX(context->layoutElements.length, context->layoutElementChildren.length) + context->exitingElementsLength + 1);
+    for (int i = 0; i < context->transitionDatas.length; ++i) {
         Clay__TransitionDataInternal *data = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
         Clay_LayoutElementHashMapItem *hashMapItem = Clay__GetHashMapItem(data->elementId);
         // This might seems strange - can't we just look up the element itself, and check the config to see whether it has an exit transition defined?
@@ -4486,7 +6538,7 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                     if (data->state != CLAY_TRANSITION_STATE_EXITING) {
                         if (parentHashMapItem->generation <= context->generation) {
                             data->elementThisFrame->config.floating.attachTo = CLAY_ATTACH_TO_ROOT;
-                            data->elementThisFrame->config.floating.offset = CLAY__INIT(Clay_Vector2) { hashMapItem->boundingBox.x, hashMapItem->boundingBox.y };
+                            data->elementThisFrame->config.floating.offset = CLAY__INIT(Clay_Vector2) { (float)hashMapItem->boundingBox.x, (float)hashMapItem->boundingBox.y };
                             data->elementThisFrame->config.floating.parentId = Clay__HashString(CLAY_STRING("Clay__RootContainer"), 0).id;
                         }
                         hashMapItem->appearedThisFrame = false;
@@ -4501,13 +6553,18 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
 
                     // Below this line runs every frame while element is exiting -----------
 
-                    // Clone the entire subtree back into the main UI layout tree
+                    // On the first frame of the exit, clone the entire subtree from last frame's snapshot back into the main UI layout tree.
+                    // After that it's retained between frames and only needs to be reattached, see Clay__RetainExitingElements()
                     Clay__int32_tArray bfsBuffer = context->openLayoutElementStack;
                     bfsBuffer.length = 0;
-                    data->elementThisFrame = Clay_LayoutElementArray_Add(&context->layoutElements, *data->elementThisFrame);
+                    bool retained = Clay__ElementIsRetained(context, data->elementThisFrame);
+                    if (!retained) {
+                        int32_t snapshotIndex = data->elementThisFrame - context->layoutElements.internalArray;
+                        data->elementThisFrame = Clay_LayoutElementArray_Add(&context->layoutElements, *data->elementThisFrame);
+                        Clay__StringArray_Add(&context->layoutElementIdStrings, *Clay__StringArray_GetCheckCapacity(&context->layoutElementIdStrings, snapshotIndex));
+                        Clay__int32_tArray_Add(&context->layoutElementClipElementIds, *Clay__int32_tArray_GetCheckCapacity(&context->layoutElementClipElementIds, snapshotIndex));
+                    }
                     int32_t exitingElementIndex = data->elementThisFrame - context->layoutElements.internalArray;
-                    Clay__StringArray_Add(&context->layoutElementIdStrings, *Clay__StringArray_GetCheckCapacity(&context->layoutElementIdStrings, exitingElementIndex));
-                    Clay__int32_tArray_Add(&context->layoutElementClipElementIds, *Clay__int32_tArray_GetCheckCapacity(&context->layoutElementClipElementIds, exitingElementIndex));
                     Clay__int32_tArray_Add(&bfsBuffer, exitingElementIndex);
                     int32_t bufferIndex = 0;
                     while (bufferIndex < bfsBuffer.length) {
@@ -4518,6 +6575,12 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                             Clay__AddHashMapItem(CLAY__INIT(Clay_ElementId){ layoutElement->id }, layoutElement);
                         }
                         bufferIndex++;
+                        if (retained) {
+                            for (int j = 0; j < layoutElement->children.length; ++j) {
+                                Clay__int32_tArray_Add(&bfsBuffer, layoutElement->children.elements[j]);
+                            }
+                            continue;
+                        }
                         int32_t firstChildSlot = context->layoutElementChildren.length;
                         for (int j = 0; j < layoutElement->children.length; ++j) {
                             Clay_LayoutElement* childElement = Clay_LayoutElementArray_GetCheckCapacity(&context->layoutElements, layoutElement->children.elements[j]);
@@ -4533,6 +6596,7 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                         }
                         layoutElement->children.elements = &context->layoutElementChildren.internalArray[firstChildSlot];
                     }
+                    Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK, bfsBuffer.length);
                     hashMapItem->layoutElement = data->elementThisFrame;
 
                     // Reattach the inserted subtree to its previous parent if it still exists
@@ -4540,6 +6604,7 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                     Clay_FloatingElementConfig* floatingConfig = &hashMapItem->layoutElement->config.floating;
                     if (parentHashMapItem->generation > context->generation && floatingConfig->attachTo == CLAY_ATTACH_TO_NONE) {
                         Clay_LayoutElement *parentElement = parentHashMapItem->layoutElement;
+                        Clay__EnsureElementCapacity(context, context->layoutElementChildren.length + parentElement->children.length + 2);
                         int32_t newChildrenStartIndex = context->layoutElementChildren.length;
                         bool found = false;
                         if (config->exit.siblingOrdering == CLAY_EXIT_TRANSITION_ORDERING_UNDERNEATH_SIBLINGS) {
@@ -4568,26 +6633,45 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                     }
                 // Parent exited, just delete child without exit transition
                 } else {
-                    Clay__TransitionDataInternalArray_RemoveSwapback(&context->transitionDatas, i);
+                    Clay__TransitionDataInternalArray_Remove(&context->transitionDatas, &context->transitionDataBuckets, i);
                     i--;
                     continue;
                 }
             }
         }
     }
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING, phaseStartTime);
 
     if (context->booleanWarnings.maxElementsExceeded) {
         Clay_String message;
         message = CLAY_STRING("Clay Error: Layout elements exceeded Clay__maxElementCount");
         Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand ) {
-            .boundingBox = { context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0 },
+            .boundingBox = Clay__BoundingBox(context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0),
             .renderData = { .text = { .stringContents = CLAY__INIT(Clay_StringSlice) { .length = message.length, .chars = message.chars, .baseChars = message.chars }, .textColor = {255, 0, 0, 255}, .fontSize = 16 } },
             .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT
         });
     } else {
         if (context->transitionDatas.length > 0) {
-            Clay__CalculateFinalLayout(deltaTime, false, false);
-
+            // If no transitions were running last frame, they usually won't change anything this frame either, so render commands
+            // are generated by the first pass and only recalculated if a transition was applied.
+            bool transitionsIdle = true;
+            for (int i = 0; i < context->transitionDatas.length; ++i) {
+                if (Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i)->state != CLAY_TRANSITION_STATE_IDLE) {
+                    transitionsIdle = false;
+                    break;
+                }
+            }
+            // Commands that have already been streamed can't be taken back, so a sink always waits for the final pass
+            bool generateRenderCommands = transitionsIdle && !context->debugModeEnabled && !context->renderCommandSink.flushFunction;
+            bool transitionsApplied = false;
+            bool transitionsResized = false;
+            Clay__CalculateSizesWithCache(context, deltaTime, transitionsIdle);
+            Clay__CalculateFinalLayout(false, generateRenderCommands);
+
+            phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_TRANSITIONS);
+            Clay__int32_tArray batchedTransitions = context->reusableElementIndexBuffer;
+            batchedTransitions.length = 0;
+            int32_t firstPendingTransition = 0;
             for (int i = 0; i < context->transitionDatas.length; ++i) {
                 Clay__TransitionDataInternal* transitionData = Clay__TransitionDataInternalArray_Get(&context->transitionDatas, i);
                 Clay_LayoutElement* currentElement = transitionData->elementThisFrame;
@@ -4612,6 +6696,8 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                         transitionData->currentState = transitionData->initialState;
                         transitionData->activeProperties = currentElement->config.transition.properties;
                         Clay_ApplyTransitionedPropertiesToElement(currentElement, currentElement->config.transition.properties, transitionData->initialState, &mapItem->boundingBox, transitionData->reparented);
+                        transitionsApplied = true;
+                        transitionsResized |= Clay__TransitionResizesElement(transitionData->activeProperties, transitionData->reparented);
                     } else {
                         transitionData->initialState = targetState;
                         transitionData->currentState = targetState;
@@ -4619,6 +6705,11 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                     }
                 } else {
                     if (transitionData->state != CLAY_TRANSITION_STATE_EXITING) {
+                        // The parent's transitioned position is read below, so it has to be evaluated first
+                        Clay__TransitionDataInternal *parentTransitionData = Clay__TransitionDataInternalArray_Find(&context->transitionDatas, &context->transitionDataBuckets, transitionData->parentId);
+                        if (parentTransitionData && parentTransitionData->evaluationPending) {
+                            Clay__EvaluateBatchedTransitions(context, &batchedTransitions, &firstPendingTransition, deltaTime, &transitionsApplied, &transitionsResized);
+                        }
                         Clay_Vector2 parentScrollOffset = parentMapItem->layoutElement->config.clip.childOffset;
                         Clay_Vector2 newRelativePosition = {
                             mapItem->boundingBox.x - parentMapItem->boundingBox.x - parentScrollOffset.x,
@@ -4691,9 +6782,13 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                         transitionData->currentState = targetState;
                         transitionData->targetState = targetState;
                         transitionData->activeProperties = CLAY_TRANSITION_PROPERTY_NONE;
+                    // Transitions using the built in curves are evaluated together once all transitions have been updated
+                    } else if (Clay__GetTransitionCurve(currentElement->config.transition.handler) != CLAY__TRANSITION_CURVE_NONE && batchedTransitions.length < batchedTransitions.capacity) {
+                        Clay__int32_tArray_Add(&batchedTransitions, i);
+                        transitionData->evaluationPending = true;
                     } else {
-                        bool transitionComplete = true;
-                        transitionComplete = currentElement->config.transition.handler(CLAY__INIT(Clay_TransitionCallbackArguments) {
+                        CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_BEGIN, CLAY_STRING("TransitionHandler"), CLAY_STRING("id"), currentElement->id);
+                        bool transitionComplete = currentElement->config.transition.handler(CLAY__INIT(Clay_TransitionCallbackArguments) {
                             transitionData->state,
                             transitionData->initialState,
                             &transitionData->currentState,
@@ -4702,22 +6797,24 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                             currentElement->config.transition.duration,
                             transitionData->activeProperties
                         });
+                        CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, CLAY_STRING("TransitionHandler"), CLAY__STRING_DEFAULT, 0);
 
-                        Clay_ApplyTransitionedPropertiesToElement(currentElement, transitionData->activeProperties, transitionData->currentState, &mapItem->boundingBox, transitionData->reparented);
-                        transitionData->elapsedTime += deltaTime;
-
-                        if (transitionComplete) {
-                            if (transitionData->state == CLAY_TRANSITION_STATE_ENTERING || transitionData->state == CLAY_TRANSITION_STATE_TRANSITIONING) {transitionData->state = CLAY_TRANSITION_STATE_IDLE;
-                                transitionData->elapsedTime = 0;
-                                transitionData->reparented = false;
-                                transitionData->activeProperties = CLAY_TRANSITION_PROPERTY_NONE;
-                            } else if (transitionData->state == CLAY_TRANSITION_STATE_EXITING) {
-                                Clay__TransitionDataInternalArray_RemoveSwapback(&context->transitionDatas, i);
-                            }
+                        if (Clay__ApplyTransitionStep(transitionData, transitionComplete, deltaTime, &transitionsApplied, &transitionsResized)) {
+                            Clay__TransitionDataInternalArray_Remove(&context->transitionDatas, &context->transitionDataBuckets, i);
+                            i--;
                         }
                     }
                 }
             }
+            Clay__SampleScratchArrayLength(context, CLAY_MEMORY_ARRAY_REUSABLE_ELEMENT_INDEX_BUFFER, batchedTransitions.length);
+            Clay__EvaluateBatchedTransitions(context, &batchedTransitions, &firstPendingTransition, deltaTime, &transitionsApplied, &transitionsResized);
+            // Indices are in ascending order, so removing finished exit transitions from the back never moves one that is still to be removed
+            for (int i = batchedTransitions.length - 1; i >= 0; --i) {
+                if (batchedTransitions.internalArray[i] < 0) {
+                    Clay__TransitionDataInternalArray_Remove(&context->transitionDatas, &context->transitionDataBuckets, -1 - batchedTransitions.internalArray[i]);
+                }
+            }
+            Clay__EndPhase(context, CLAY_LAYOUT_PHASE_TRANSITIONS, phaseStartTime);
 
             if (context->debugModeEnabled) {
                 context->warningsEnabled = false;
@@ -4729,13 +6826,21 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                 Clay_String message;
                 message = CLAY_STRING("Clay Error: Debug view caused layout element count to exceed Clay__maxElementCount");
                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand ) {
-                        .boundingBox = { context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0 },
+                        .boundingBox = Clay__BoundingBox(context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0),
                         .renderData = { .text = { .stringContents = CLAY__INIT(Clay_StringSlice) { .length = message.length, .chars = message.chars, .baseChars = message.chars }, .textColor = {255, 0, 0, 255}, .fontSize = 16 } },
                         .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT
                 });
             } else {
-                Clay__CalculateFinalLayout(deltaTime, true, true);
+                if (!generateRenderCommands || transitionsApplied) {
+                    // Sizes only need to be recalculated if a transition changed the dimensions of an element, or the debug view was added
+                    if (transitionsResized || context->debugModeEnabled) {
+                        Clay__CalculateSizes(deltaTime, false);
+                    }
+                    Clay__CalculateFinalLayout(true, true);
+                }
+                phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING);
                 Clay__CloneElementsWithExitTransition();
+                Clay__EndPhase(context, CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING, phaseStartTime);
             }
         } else {
             if (context->debugModeEnabled) {
@@ -4748,16 +6853,21 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
                 Clay_String message;
                 message = CLAY_STRING("Clay Error: Debug view caused layout element count to exceed Clay__maxElementCount");
                 Clay__AddRenderCommand(CLAY__INIT(Clay_RenderCommand ) {
-                    .boundingBox = { context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0 },
+                    .boundingBox = Clay__BoundingBox(context->layoutDimensions.width / 2 - 59 * 4, context->layoutDimensions.height / 2, 0, 0),
                     .renderData = { .text = { .stringContents = CLAY__INIT(Clay_StringSlice) { .length = message.length, .chars = message.chars, .baseChars = message.chars }, .textColor = {255, 0, 0, 255}, .fontSize = 16 } },
                     .commandType = CLAY_RENDER_COMMAND_TYPE_TEXT
                 });
             } else {
-                Clay__CalculateFinalLayout(deltaTime, false, true);
+                Clay__CalculateSizesWithCache(context, deltaTime, true);
+                Clay__CalculateFinalLayout(false, true);
             }
         }
     }
 
+    // Sampled before pruning, as the hash map has to hold the elements from this frame and the previous one
+    Clay__SampleMemoryArrayLengths(context);
+
+    phaseStartTime = Clay__BeginPhase(context, CLAY_LAYOUT_PHASE_HASH_MAP_PRUNING);
     for (int i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
         int32_t currentElementIndex = context->layoutElementsHashMap.internalArray[i];
         int32_t previousElementIndex = -1;
@@ -4786,8 +6896,23 @@ Clay_RenderCommandArray Clay_EndLayout(float deltaTime) {
             }
         }
     }
+    Clay__EndPhase(context, CLAY_LAYOUT_PHASE_HASH_MAP_PRUNING, phaseStartTime);
 
-    return context->renderCommands;
+    Clay__FlushRenderCommands(context);
+    context->frameStats.elementCount = context->layoutElements.length;
+    context->frameStats.renderCommandCount = context->flushedRenderCommandCount + Clay__GetRenderCommandOutput(context)->length;
+    if (context->instrumentationHooks.timeFunction) {
+        context->frameStats.totalTime = context->instrumentationHooks.timeFunction(context->instrumentationHooks.userData) - context->declarationStartTime;
+    }
+    context->lastFrameStats = context->frameStats;
+    context->frameStats = CLAY__INIT(Clay_FrameStats) CLAY__DEFAULT_STRUCT;
+    Clay__RecordFlightRecorderFrame(context, deltaTime);
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_END, CLAY_STRING("Frame"), CLAY__STRING_DEFAULT, 0);
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_COUNTER, CLAY_STRING("ElementCount"), CLAY_STRING("value"), (uint32_t)context->lastFrameStats.elementCount);
+    CLAY__TRACE(context, CLAY__TRACE_EVENT_TYPE_COUNTER, CLAY_STRING("RenderCommandCount"), CLAY_STRING("value"), (uint32_t)context->lastFrameStats.renderCommandCount);
+    CLAY__RECORD(Clay__FlushRecordBuffer(context));
+
+    return *Clay__GetRenderCommandOutput(context);
 }
 
 CLAY_WASM_EXPORT("Clay_GetOpenElementId")
@@ -4844,20 +6969,16 @@ bool Clay_PointerOver(Clay_ElementId elementId) { // TODO return priority for se
 CLAY_WASM_EXPORT("Clay_GetScrollContainerData")
 Clay_ScrollContainerData Clay_GetScrollContainerData(Clay_ElementId id) {
     Clay_Context* context = Clay_GetCurrentContext();
-    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
-        Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Get(&context->scrollContainerDatas, i);
-        if (scrollContainerData->elementId == id.id) {
-            if (!scrollContainerData->layoutElement) { // This can happen on the first frame before a scroll container is declared
-                return CLAY__INIT(Clay_ScrollContainerData) CLAY__DEFAULT_STRUCT;
-            }
-            return CLAY__INIT(Clay_ScrollContainerData) {
-                .scrollPosition = &scrollContainerData->scrollPosition,
-                .scrollContainerDimensions = { scrollContainerData->boundingBox.width, scrollContainerData->boundingBox.height },
-                .contentDimensions = scrollContainerData->contentSize,
-                .config = scrollContainerData->layoutElement->config.clip,
-                .found = true
-            };
-        }
+    Clay__ScrollContainerDataInternal *scrollContainerData = Clay__ScrollContainerDataInternalArray_Find(&context->scrollContainerDatas, &context->scrollContainerDataBuckets, id.id);
+    // The layout element can be missing on the first frame before a scroll container is declared
+    if (scrollContainerData && scrollContainerData->layoutElement) {
+        return CLAY__INIT(Clay_ScrollContainerData) {
+            .scrollPosition = &scrollContainerData->scrollPosition,
+            .scrollContainerDimensions = { (float)scrollContainerData->boundingBox.width, (float)scrollContainerData->boundingBox.height },
+            .contentDimensions = scrollContainerData->contentSize,
+            .config = scrollContainerData->layoutElement->config.clip,
+            .found = true
+        };
     }
     return CLAY__INIT(Clay_ScrollContainerData) CLAY__DEFAULT_STRUCT;
 }
@@ -4887,6 +7008,35 @@ bool Clay_IsDebugModeEnabled(void) {
     return context->debugModeEnabled;
 }
 
+CLAY_WASM_EXPORT("Clay_NeedsAnotherFrame")
+bool Clay_NeedsAnotherFrame(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < context->transitionDatas.length; ++i) {
+        if (context->transitionDatas.internalArray[i].state != CLAY_TRANSITION_STATE_IDLE) {
+            return true;
+        }
+    }
+    for (int32_t i = 0; i < context->scrollContainerDatas.length; ++i) {
+        Clay_Vector2 momentum = context->scrollContainerDatas.internalArray[i].scrollMomentum;
+        if (momentum.x != 0 || momentum.y != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CLAY_WASM_EXPORT("Clay_SetRenderCommandSink")
+void Clay_SetRenderCommandSink(Clay_RenderCommandSink sink) {
+    Clay_GetCurrentContext()->renderCommandSink = sink;
+}
+
+CLAY_WASM_EXPORT("Clay_SetRenderCommandBuffer")
+void Clay_SetRenderCommandBuffer(Clay_RenderCommandBuffer buffer) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->renderCommandBuffer = buffer;
+    context->bufferedRenderCommands = CLAY__INIT(Clay_RenderCommandArray) { .capacity = buffer.memory ? buffer.capacity : 0, .internalArray = buffer.memory };
+}
+
 CLAY_WASM_EXPORT("Clay_SetCullingEnabled")
 void Clay_SetCullingEnabled(bool enabled) {
     Clay_Context* context = Clay_GetCurrentContext();
@@ -4945,65 +7095,941 @@ void Clay_ResetMeasureTextCache(void) {
         context->measureTextHashMap.internalArray[i] = 0;
     }
     context->measureTextHashMapInternal.length = 1; // Reserve the 0 value to mean "no next element"
+    context->sizeCacheValid = false;
 }
 
-#define CLAY__LERP(from, to, mix) (from + (to - from) * mix)
-
-CLAY_DLL_EXPORT bool Clay_EaseOut(Clay_TransitionCallbackArguments arguments) {
-    float ratio = 1;
-    if (arguments.duration > 0) {
-        ratio = CLAY__MIN(arguments.elapsedTime / arguments.duration, 1);
-    }
-    float inverse = 1.0f - ratio;
-    float lerpAmount = 1.0f - (inverse * inverse * inverse);
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_X) {
-        arguments.current->boundingBox.x = CLAY__LERP(arguments.initial.boundingBox.x, arguments.target.boundingBox.x, lerpAmount);
-    }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_Y) {
-        arguments.current->boundingBox.y = CLAY__LERP(arguments.initial.boundingBox.y, arguments.target.boundingBox.y, lerpAmount);
-    }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_WIDTH) {
-        arguments.current->boundingBox.width = CLAY__LERP(arguments.initial.boundingBox.width, arguments.target.boundingBox.width, lerpAmount);
-    }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_HEIGHT) {
-        arguments.current->boundingBox.height = CLAY__LERP(arguments.initial.boundingBox.height, arguments.target.boundingBox.height, lerpAmount);
-    }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_BACKGROUND_COLOR) {
-        arguments.current->backgroundColor = CLAY__INIT(Clay_Color) {
-            .r = CLAY__LERP(arguments.initial.backgroundColor.r, arguments.target.backgroundColor.r, lerpAmount),
-            .g = CLAY__LERP(arguments.initial.backgroundColor.g, arguments.target.backgroundColor.g, lerpAmount),
-            .b = CLAY__LERP(arguments.initial.backgroundColor.b, arguments.target.backgroundColor.b, lerpAmount),
-            .a = CLAY__LERP(arguments.initial.backgroundColor.a, arguments.target.backgroundColor.a, lerpAmount),
+CLAY_WASM_EXPORT("Clay_GetMemoryStats")
+Clay_MemoryStats Clay_GetMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay_MemoryStats stats = CLAY__DEFAULT_STRUCT;
+    stats.arenaBytesUsed = (size_t)context->internalArena.nextAllocation;
+    stats.arenaCapacityBytes = context->internalArena.capacity;
+    stats.committedBytes = sizeof(Clay_Context);
+    stats.peakBytesUsed = sizeof(Clay_Context);
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        Clay__MemoryArrayInfo info = Clay__GetMemoryArrayInfo(context, (Clay_MemoryArrayType)i);
+        stats.arrays[i] = CLAY__INIT(Clay_MemoryArrayStats) {
+            .name = info.name,
+            .length = context->memoryArrayLengths[i],
+            .peakLength = context->memoryArrayPeakLengths[i],
+            .capacity = info.capacity,
+            .itemSize = info.itemSize,
         };
+        stats.committedBytes += (size_t)info.capacity * info.itemSize;
+        stats.peakBytesUsed += (size_t)context->memoryArrayPeakLengths[i] * info.itemSize;
     }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_OVERLAY_COLOR) {
-        arguments.current->overlayColor = CLAY__INIT(Clay_Color) {
-            .r = CLAY__LERP(arguments.initial.overlayColor.r, arguments.target.overlayColor.r, lerpAmount),
-            .g = CLAY__LERP(arguments.initial.overlayColor.g, arguments.target.overlayColor.g, lerpAmount),
-            .b = CLAY__LERP(arguments.initial.overlayColor.b, arguments.target.overlayColor.b, lerpAmount),
-            .a = CLAY__LERP(arguments.initial.overlayColor.a, arguments.target.overlayColor.a, lerpAmount),
-        };
+
+    Clay_HashMapStats *elementStats = &stats.elementHashMap;
+    elementStats->bucketCount = context->layoutElementsHashMap.capacity;
+    for (int32_t i = 0; i < context->layoutElementsHashMap.capacity; ++i) {
+        int32_t chainLength = 0;
+        for (int32_t itemIndex = context->layoutElementsHashMap.internalArray[i]; itemIndex != -1; itemIndex = Clay__LayoutElementHashMapItemArray_Get(&context->layoutElementsHashMapInternal, itemIndex)->nextIndex) {
+            chainLength++;
+        }
+        elementStats->itemCount += chainLength;
+        elementStats->usedBucketCount += chainLength > 0;
+        elementStats->maxChainLength = CLAY__MAX(elementStats->maxChainLength, chainLength);
     }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_BORDER_COLOR) {
-        arguments.current->borderColor = CLAY__INIT(Clay_Color) {
-            .r = CLAY__LERP(arguments.initial.borderColor.r, arguments.target.borderColor.r, lerpAmount),
-            .g = CLAY__LERP(arguments.initial.borderColor.g, arguments.target.borderColor.g, lerpAmount),
-            .b = CLAY__LERP(arguments.initial.borderColor.b, arguments.target.borderColor.b, lerpAmount),
-            .a = CLAY__LERP(arguments.initial.borderColor.a, arguments.target.borderColor.a, lerpAmount),
-        };
+
+    // Index 0 of the measure text cache is reserved to mean "no next element"
+    Clay_HashMapStats *measureTextStats = &stats.measureTextHashMap;
+    measureTextStats->bucketCount = context->measureTextHashMap.capacity;
+    for (int32_t i = 0; i < measureTextStats->bucketCount; ++i) {
+        int32_t chainLength = 0;
+        for (int32_t itemIndex = context->measureTextHashMap.internalArray[i]; itemIndex != 0; itemIndex = Clay__MeasureTextCacheItemArray_Get(&context->measureTextHashMapInternal, itemIndex)->nextIndex) {
+            chainLength++;
+        }
+        measureTextStats->itemCount += chainLength;
+        measureTextStats->usedBucketCount += chainLength > 0;
+        measureTextStats->maxChainLength = CLAY__MAX(measureTextStats->maxChainLength, chainLength);
     }
-    if (arguments.properties & CLAY_TRANSITION_PROPERTY_BORDER_WIDTH) {
-        arguments.current->borderWidth = CLAY__INIT(Clay_BorderWidth) {
-            .left = (uint16_t)CLAY__LERP(arguments.initial.borderWidth.left, arguments.target.borderWidth.left, lerpAmount),
-            .right = (uint16_t)CLAY__LERP(arguments.initial.borderWidth.right, arguments.target.borderWidth.right, lerpAmount),
-            .top = (uint16_t)CLAY__LERP(arguments.initial.borderWidth.top, arguments.target.borderWidth.top, lerpAmount),
-            .bottom = (uint16_t)CLAY__LERP(arguments.initial.borderWidth.bottom, arguments.target.borderWidth.bottom, lerpAmount),
-            .betweenChildren = (uint16_t)CLAY__LERP(arguments.initial.borderWidth.betweenChildren, arguments.target.borderWidth.betweenChildren, lerpAmount),
-        };
+
+    Clay_HashMapStats *hashMapStats[] = { elementStats, measureTextStats };
+    for (int32_t i = 0; i < 2; ++i) {
+        Clay_HashMapStats *hashMap = hashMapStats[i];
+        hashMap->loadFactor = hashMap->bucketCount > 0 ? (float)hashMap->itemCount / (float)hashMap->bucketCount : 0;
+        hashMap->averageChainLength = hashMap->usedBucketCount > 0 ? (float)hashMap->itemCount / (float)hashMap->usedBucketCount : 0;
+    }
+    return stats;
+}
+
+CLAY_WASM_EXPORT("Clay_ResetMemoryStats")
+void Clay_ResetMemoryStats(void) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        context->memoryArrayPeakLengths[i] = context->memoryArrayLengths[i];
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_SetInstrumentationHooks")
+void Clay_SetInstrumentationHooks(Clay_InstrumentationHooks hooks) {
+    Clay_GetCurrentContext()->instrumentationHooks = hooks;
+}
+
+CLAY_WASM_EXPORT("Clay_GetFrameStats")
+Clay_FrameStats Clay_GetFrameStats(void) {
+    return Clay_GetCurrentContext()->lastFrameStats;
+}
+
+CLAY_WASM_EXPORT("Clay_GetFlightRecorderFrames")
+int32_t Clay_GetFlightRecorderFrames(Clay_FlightRecorderFrame *frames, int32_t maxFrameCount) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    uint32_t frameCount = CLAY__MIN(context->flightRecorderFrameCount, (uint32_t)CLAY_FLIGHT_RECORDER_FRAME_COUNT);
+    frameCount = CLAY__MIN(frameCount, (uint32_t)CLAY__MAX(maxFrameCount, 0));
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        frames[i] = context->flightRecorderFrames[(context->flightRecorderFrameCount - frameCount + i) % CLAY_FLIGHT_RECORDER_FRAME_COUNT];
+    }
+    return (int32_t)frameCount;
+}
+
+CLAY_WASM_EXPORT("Clay_GetLayoutPhaseName")
+Clay_String Clay_GetLayoutPhaseName(Clay_LayoutPhase phase) {
+    switch (phase) {
+        case CLAY_LAYOUT_PHASE_DECLARATION: return CLAY_STRING("Declaration");
+        case CLAY_LAYOUT_PHASE_EXIT_TRANSITION_CLONING: return CLAY_STRING("ExitTransitionCloning");
+        case CLAY_LAYOUT_PHASE_SIZE_X: return CLAY_STRING("SizeX");
+        case CLAY_LAYOUT_PHASE_TEXT_WRAPPING: return CLAY_STRING("TextWrapping");
+        case CLAY_LAYOUT_PHASE_PROPAGATE_HEIGHTS: return CLAY_STRING("PropagateHeights");
+        case CLAY_LAYOUT_PHASE_SIZE_Y: return CLAY_STRING("SizeY");
+        case CLAY_LAYOUT_PHASE_FINAL_LAYOUT: return CLAY_STRING("FinalLayout");
+        case CLAY_LAYOUT_PHASE_TRANSITIONS: return CLAY_STRING("Transitions");
+        case CLAY_LAYOUT_PHASE_HASH_MAP_PRUNING: return CLAY_STRING("HashMapPruning");
+        case CLAY_LAYOUT_PHASE_POINTER_HIT_TESTING: return CLAY_STRING("PointerHitTesting");
+        default: return CLAY_STRING("Unknown");
+    }
+}
+
+// Compact render command format: each record starts with a Clay_RenderCommandType byte and a byte of Clay__CompactRecordFlags,
+// followed by the fields that the flags mark as present in this order: id, bounding box, zIndex, userData, then the data for
+// the command type. Bounding boxes and corner radii are stored as int16 when every value is a whole number that fits, colors as
+// one byte per channel when every channel is a whole number from 0 to 255, and small integers as LEB128 varints.
+// All multi byte values are little endian, and pointers are sizeof(uintptr_t) bytes.
+// SCISSOR_END and OVERLAY_COLOR_END records only store their type and zIndex, as renderers don't need anything else to handle them.
+// With CLAY_RESOLVED_CLIP_RECTS, every record ends with its clipRect and overlayColor as floats.
+typedef enum {
+    CLAY__COMPACT_RECORD_ID = 1 << 0,
+    CLAY__COMPACT_RECORD_BOUNDING_BOX = 1 << 1,
+    CLAY__COMPACT_RECORD_Z_INDEX = 1 << 2,
+    CLAY__COMPACT_RECORD_USER_DATA = 1 << 3,
+    CLAY__COMPACT_RECORD_FLOAT_VALUES = 1 << 4,
+    CLAY__COMPACT_RECORD_FLOAT_COLOR = 1 << 5,
+    CLAY__COMPACT_RECORD_CORNER_RADIUS = 1 << 6,
+    CLAY__COMPACT_RECORD_UNIFORM_CORNER_RADIUS = 1 << 7,
+} Clay__CompactRecordFlags;
+
+typedef struct {
+    uint8_t *buffer;
+    int32_t capacity;
+    int32_t length;
+} Clay__CompactWriter;
+
+void Clay__CompactWriteUInt8(Clay__CompactWriter *writer, uint8_t value) {
+    if (writer->length < writer->capacity) {
+        writer->buffer[writer->length] = value;
+    }
+    writer->length++;
+}
+
+void Clay__CompactWriteUInt(Clay__CompactWriter *writer, uint64_t value, int32_t byteCount) {
+    for (int32_t i = 0; i < byteCount; ++i) {
+        Clay__CompactWriteUInt8(writer, (uint8_t)(value >> (i * 8)));
+    }
+}
+
+void Clay__CompactWriteVarUInt(Clay__CompactWriter *writer, uint32_t value) {
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        Clay__CompactWriteUInt8(writer, (uint8_t)(byte | (value > 0 ? 0x80 : 0)));
+    } while (value > 0);
+}
+
+void Clay__CompactWriteValue(Clay__CompactWriter *writer, float value, bool floatValues) {
+    if (floatValues) {
+        union { float f; uint32_t u; } bits;
+        bits.f = value;
+        Clay__CompactWriteUInt(writer, bits.u, 4);
+    } else {
+        Clay__CompactWriteUInt(writer, (uint16_t)(int16_t)value, 2);
+    }
+}
+
+bool Clay__CompactFitsInt16(float value) {
+    return value >= -32768 && value <= 32767 && value == (float)(int16_t)value;
+}
+
+bool Clay__CompactFitsByte(float value) {
+    return value >= 0 && value <= 255 && value == (float)(uint8_t)value;
+}
+
+CLAY_WASM_EXPORT("Clay_WriteCompactRenderCommands")
+int32_t Clay_WriteCompactRenderCommands(Clay_RenderCommandArray renderCommands, uint8_t *buffer, int32_t bufferSize) {
+    Clay__CompactWriter writer = { buffer, CLAY__MAX(bufferSize, 0), 0 };
+    int16_t previousZIndex = 0;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *command = &renderCommands.internalArray[i];
+        Clay_RenderData *data = &command->renderData;
+        bool isEnd = command->commandType == CLAY_RENDER_COMMAND_TYPE_SCISSOR_END || command->commandType == CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_END;
+        // Corner radius and color live at the same offsets in all of the render data structs that have them
+        bool hasColor = false;
+        bool hasCornerRadius = false;
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: hasColor = true; hasCornerRadius = true; break;
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START: hasColor = true; break;
+            default: break;
+        }
+        Clay_Color color = command->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT ? data->text.textColor
+            : command->commandType == CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START ? data->overlayColor.color
+            : data->rectangle.backgroundColor;
+        Clay_CornerRadius radius = hasCornerRadius ? data->rectangle.cornerRadius : CLAY__INIT(Clay_CornerRadius) CLAY__DEFAULT_STRUCT;
+        Clay_BoundingBox box = command->boundingBox;
+
+        uint8_t flags = 0;
+        if (command->id != 0 && !isEnd) flags |= CLAY__COMPACT_RECORD_ID;
+        if (!isEnd && (box.x != 0 || box.y != 0 || box.width != 0 || box.height != 0)) flags |= CLAY__COMPACT_RECORD_BOUNDING_BOX;
+        if (command->zIndex != previousZIndex) flags |= CLAY__COMPACT_RECORD_Z_INDEX;
+        if (command->userData && !isEnd) flags |= CLAY__COMPACT_RECORD_USER_DATA;
+        if (radius.topLeft != 0 || radius.topRight != 0 || radius.bottomLeft != 0 || radius.bottomRight != 0) {
+            flags |= CLAY__COMPACT_RECORD_CORNER_RADIUS;
+            if (radius.topLeft == radius.topRight && radius.topLeft == radius.bottomLeft && radius.topLeft == radius.bottomRight) {
+                flags |= CLAY__COMPACT_RECORD_UNIFORM_CORNER_RADIUS;
+            }
+        }
+        if (!(Clay__CompactFitsInt16(box.x) && Clay__CompactFitsInt16(box.y) && Clay__CompactFitsInt16(box.width) && Clay__CompactFitsInt16(box.height)
+            && Clay__CompactFitsInt16(radius.topLeft) && Clay__CompactFitsInt16(radius.topRight) && Clay__CompactFitsInt16(radius.bottomLeft) && Clay__CompactFitsInt16(radius.bottomRight))) {
+            flags |= CLAY__COMPACT_RECORD_FLOAT_VALUES;
+        }
+        if (hasColor && !(Clay__CompactFitsByte(color.r) && Clay__CompactFitsByte(color.g) && Clay__CompactFitsByte(color.b) && Clay__CompactFitsByte(color.a))) {
+            flags |= CLAY__COMPACT_RECORD_FLOAT_COLOR;
+        }
+        bool floatValues = flags & CLAY__COMPACT_RECORD_FLOAT_VALUES;
+
+        Clay__CompactWriteUInt8(&writer, (uint8_t)command->commandType);
+        Clay__CompactWriteUInt8(&writer, flags);
+        if (flags & CLAY__COMPACT_RECORD_ID) {
+            Clay__CompactWriteUInt(&writer, command->id, 4);
+        }
+        if (flags & CLAY__COMPACT_RECORD_BOUNDING_BOX) {
+            Clay__CompactWriteValue(&writer, box.x, floatValues);
+            Clay__CompactWriteValue(&writer, box.y, floatValues);
+            Clay__CompactWriteValue(&writer, box.width, floatValues);
+            Clay__CompactWriteValue(&writer, box.height, floatValues);
+        }
+        if (flags & CLAY__COMPACT_RECORD_Z_INDEX) {
+            Clay__CompactWriteUInt(&writer, (uint16_t)command->zIndex, 2);
+            previousZIndex = command->zIndex;
+        }
+        if (flags & CLAY__COMPACT_RECORD_USER_DATA) {
+            Clay__CompactWriteUInt(&writer, (uintptr_t)command->userData, sizeof(uintptr_t));
+        }
+        if (hasColor) {
+            if (flags & CLAY__COMPACT_RECORD_FLOAT_COLOR) {
+                Clay__CompactWriteValue(&writer, color.r, true);
+                Clay__CompactWriteValue(&writer, color.g, true);
+                Clay__CompactWriteValue(&writer, color.b, true);
+                Clay__CompactWriteValue(&writer, color.a, true);
+            } else {
+                Clay__CompactWriteUInt8(&writer, (uint8_t)color.r);
+                Clay__CompactWriteUInt8(&writer, (uint8_t)color.g);
+                Clay__CompactWriteUInt8(&writer, (uint8_t)color.b);
+                Clay__CompactWriteUInt8(&writer, (uint8_t)color.a);
+            }
+        }
+        if (flags & CLAY__COMPACT_RECORD_UNIFORM_CORNER_RADIUS) {
+            Clay__CompactWriteValue(&writer, radius.topLeft, floatValues);
+        } else if (flags & CLAY__COMPACT_RECORD_CORNER_RADIUS) {
+            Clay__CompactWriteValue(&writer, radius.topLeft, floatValues);
+            Clay__CompactWriteValue(&writer, radius.topRight, floatValues);
+            Clay__CompactWriteValue(&writer, radius.bottomLeft, floatValues);
+            Clay__CompactWriteValue(&writer, radius.bottomRight, floatValues);
+        }
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+                Clay__CompactWriteVarUInt(&writer, data->border.width.left);
+                Clay__CompactWriteVarUInt(&writer, data->border.width.right);
+                Clay__CompactWriteVarUInt(&writer, data->border.width.top);
+                Clay__CompactWriteVarUInt(&writer, data->border.width.bottom);
+                Clay__CompactWriteVarUInt(&writer, data->border.width.betweenChildren);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+                Clay_StringSlice *text = &data->text.stringContents;
+                Clay__CompactWriteVarUInt(&writer, data->text.fontId);
+                Clay__CompactWriteVarUInt(&writer, data->text.fontSize);
+                Clay__CompactWriteVarUInt(&writer, data->text.letterSpacing);
+                Clay__CompactWriteVarUInt(&writer, data->text.lineHeight);
+                Clay__CompactWriteVarUInt(&writer, (uint32_t)text->length);
+                Clay__CompactWriteUInt(&writer, (uintptr_t)text->chars, sizeof(uintptr_t));
+                // baseChars is stored as an offset back from chars, as wrapped lines are always slices of the original string
+                Clay__CompactWriteVarUInt(&writer, text->baseChars ? (uint32_t)(text->chars - text->baseChars) : 0);
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+                Clay__CompactWriteUInt(&writer, (uintptr_t)data->image.imageData, sizeof(uintptr_t));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                Clay__CompactWriteUInt(&writer, (uintptr_t)data->custom.customData, sizeof(uintptr_t));
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                Clay__CompactWriteUInt8(&writer, (uint8_t)(data->clip.horizontal | (data->clip.vertical << 1)));
+                break;
+            }
+            default: break;
+        }
+        #ifdef CLAY_RESOLVED_CLIP_RECTS
+        Clay__CompactWriteValue(&writer, command->clipRect.x, true);
+        Clay__CompactWriteValue(&writer, command->clipRect.y, true);
+        Clay__CompactWriteValue(&writer, command->clipRect.width, true);
+        Clay__CompactWriteValue(&writer, command->clipRect.height, true);
+        Clay__CompactWriteValue(&writer, command->overlayColor.r, true);
+        Clay__CompactWriteValue(&writer, command->overlayColor.g, true);
+        Clay__CompactWriteValue(&writer, command->overlayColor.b, true);
+        Clay__CompactWriteValue(&writer, command->overlayColor.a, true);
+        #endif
+    }
+    return writer.length;
+}
+
+typedef struct {
+    const uint8_t *data;
+    int32_t length;
+    int32_t offset;
+} Clay__CompactReader;
+
+uint64_t Clay__CompactReadUInt(Clay__CompactReader *reader, int32_t byteCount) {
+    uint64_t value = 0;
+    for (int32_t i = 0; i < byteCount; ++i) {
+        if (reader->offset < reader->length) {
+            value |= (uint64_t)reader->data[reader->offset] << (i * 8);
+        }
+        reader->offset++;
+    }
+    return value;
+}
+
+uint32_t Clay__CompactReadVarUInt(Clay__CompactReader *reader) {
+    uint32_t value = 0;
+    for (int32_t shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = (uint8_t)Clay__CompactReadUInt(reader, 1);
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+float Clay__CompactReadValue(Clay__CompactReader *reader, bool floatValues) {
+    if (floatValues) {
+        union { float f; uint32_t u; } bits;
+        bits.u = (uint32_t)Clay__CompactReadUInt(reader, 4);
+        return bits.f;
+    }
+    return (float)(int16_t)(uint16_t)Clay__CompactReadUInt(reader, 2);
+}
+
+CLAY_WASM_EXPORT("Clay_ReadCompactRenderCommand")
+bool Clay_ReadCompactRenderCommand(Clay_CompactRenderCommandReader *reader, Clay_RenderCommand *renderCommand) {
+    Clay__CompactReader record = { reader->data, reader->length, reader->offset };
+    if (record.offset + 2 > record.length) {
+        return false;
+    }
+    Clay_RenderCommand command = CLAY__DEFAULT_STRUCT;
+    Clay_RenderData *data = &command.renderData;
+    command.commandType = (Clay_RenderCommandType)Clay__CompactReadUInt(&record, 1);
+    uint8_t flags = (uint8_t)Clay__CompactReadUInt(&record, 1);
+    bool floatValues = flags & CLAY__COMPACT_RECORD_FLOAT_VALUES;
+    command.zIndex = reader->zIndex;
+    if (flags & CLAY__COMPACT_RECORD_ID) {
+        command.id = (uint32_t)Clay__CompactReadUInt(&record, 4);
+    }
+    if (flags & CLAY__COMPACT_RECORD_BOUNDING_BOX) {
+        command.boundingBox.x = Clay__CompactReadValue(&record, floatValues);
+        command.boundingBox.y = Clay__CompactReadValue(&record, floatValues);
+        command.boundingBox.width = Clay__CompactReadValue(&record, floatValues);
+        command.boundingBox.height = Clay__CompactReadValue(&record, floatValues);
+    }
+    if (flags & CLAY__COMPACT_RECORD_Z_INDEX) {
+        command.zIndex = (int16_t)(uint16_t)Clay__CompactReadUInt(&record, 2);
+    }
+    if (flags & CLAY__COMPACT_RECORD_USER_DATA) {
+        command.userData = (void *)(uintptr_t)Clay__CompactReadUInt(&record, sizeof(uintptr_t));
+    }
+    Clay_Color color = CLAY__DEFAULT_STRUCT;
+    switch (command.commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+        case CLAY_RENDER_COMMAND_TYPE_BORDER:
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM:
+        case CLAY_RENDER_COMMAND_TYPE_TEXT:
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START: {
+            bool floatColor = flags & CLAY__COMPACT_RECORD_FLOAT_COLOR;
+            color.r = floatColor ? Clay__CompactReadValue(&record, true) : (float)Clay__CompactReadUInt(&record, 1);
+            color.g = floatColor ? Clay__CompactReadValue(&record, true) : (float)Clay__CompactReadUInt(&record, 1);
+            color.b = floatColor ? Clay__CompactReadValue(&record, true) : (float)Clay__CompactReadUInt(&record, 1);
+            color.a = floatColor ? Clay__CompactReadValue(&record, true) : (float)Clay__CompactReadUInt(&record, 1);
+            break;
+        }
+        default: break;
+    }
+    Clay_CornerRadius radius = CLAY__DEFAULT_STRUCT;
+    if (flags & CLAY__COMPACT_RECORD_UNIFORM_CORNER_RADIUS) {
+        radius.topLeft = radius.topRight = radius.bottomLeft = radius.bottomRight = Clay__CompactReadValue(&record, floatValues);
+    } else if (flags & CLAY__COMPACT_RECORD_CORNER_RADIUS) {
+        radius.topLeft = Clay__CompactReadValue(&record, floatValues);
+        radius.topRight = Clay__CompactReadValue(&record, floatValues);
+        radius.bottomLeft = Clay__CompactReadValue(&record, floatValues);
+        radius.bottomRight = Clay__CompactReadValue(&record, floatValues);
+    }
+    switch (command.commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            data->rectangle.backgroundColor = color;
+            data->rectangle.cornerRadius = radius;
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            data->border.color = color;
+            data->border.cornerRadius = radius;
+            data->border.width.left = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->border.width.right = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->border.width.top = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->border.width.bottom = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->border.width.betweenChildren = (uint16_t)Clay__CompactReadVarUInt(&record);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            data->text.textColor = color;
+            data->text.fontId = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->text.fontSize = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->text.letterSpacing = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->text.lineHeight = (uint16_t)Clay__CompactReadVarUInt(&record);
+            data->text.stringContents.length = (int32_t)Clay__CompactReadVarUInt(&record);
+            data->text.stringContents.chars = (const char *)(uintptr_t)Clay__CompactReadUInt(&record, sizeof(uintptr_t));
+            data->text.stringContents.baseChars = data->text.stringContents.chars - Clay__CompactReadVarUInt(&record);
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            data->image.backgroundColor = color;
+            data->image.cornerRadius = radius;
+            data->image.imageData = (void *)(uintptr_t)Clay__CompactReadUInt(&record, sizeof(uintptr_t));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            data->custom.backgroundColor = color;
+            data->custom.cornerRadius = radius;
+            data->custom.customData = (void *)(uintptr_t)Clay__CompactReadUInt(&record, sizeof(uintptr_t));
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+            uint8_t clip = (uint8_t)Clay__CompactReadUInt(&record, 1);
+            data->clip.horizontal = clip & 1;
+            data->clip.vertical = (clip >> 1) & 1;
+            break;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START: {
+            data->overlayColor.color = color;
+            break;
+        }
+        default: break;
+    }
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    command.clipRect.x = Clay__CompactReadValue(&record, true);
+    command.clipRect.y = Clay__CompactReadValue(&record, true);
+    command.clipRect.width = Clay__CompactReadValue(&record, true);
+    command.clipRect.height = Clay__CompactReadValue(&record, true);
+    command.overlayColor.r = Clay__CompactReadValue(&record, true);
+    command.overlayColor.g = Clay__CompactReadValue(&record, true);
+    command.overlayColor.b = Clay__CompactReadValue(&record, true);
+    command.overlayColor.a = Clay__CompactReadValue(&record, true);
+    #endif
+    // Reads past the end of a truncated stream return zeroes, so the record is only accepted if it was read in full
+    if (record.offset > record.length) {
+        return false;
+    }
+    reader->offset = record.offset;
+    reader->zIndex = command.zIndex;
+    *renderCommand = command;
+    return true;
+}
+
+uint64_t Clay__HashLayerPointer(uint64_t hash, const void *pointer) {
+    uint64_t bits = (uint64_t)(uintptr_t)pointer;
+    hash = Clay__HashSizingValue(hash, (uint32_t)bits);
+    return Clay__HashSizingValue(hash, (uint32_t)(bits >> 32));
+}
+
+uint64_t Clay__HashLayerColor(uint64_t hash, Clay_Color color) {
+    hash = Clay__HashSizingFloat(hash, color.r);
+    hash = Clay__HashSizingFloat(hash, color.g);
+    hash = Clay__HashSizingFloat(hash, color.b);
+    return Clay__HashSizingFloat(hash, color.a);
+}
+
+uint64_t Clay__HashLayerCornerRadius(uint64_t hash, Clay_CornerRadius radius) {
+    hash = Clay__HashSizingFloat(hash, radius.topLeft);
+    hash = Clay__HashSizingFloat(hash, radius.topRight);
+    hash = Clay__HashSizingFloat(hash, radius.bottomLeft);
+    return Clay__HashSizingFloat(hash, radius.bottomRight);
+}
+
+// Fields are hashed individually rather than as raw bytes, as padding inside Clay_RenderCommand isn't guaranteed to be zeroed.
+uint64_t Clay__HashRenderCommand(uint64_t hash, Clay_RenderCommand *command) {
+    Clay_RenderData *data = &command->renderData;
+    hash = Clay__HashSizingValue(hash, command->commandType);
+    hash = Clay__HashSizingValue(hash, command->id);
+    hash = Clay__HashSizingFloat(hash, command->boundingBox.x);
+    hash = Clay__HashSizingFloat(hash, command->boundingBox.y);
+    hash = Clay__HashSizingFloat(hash, command->boundingBox.width);
+    hash = Clay__HashSizingFloat(hash, command->boundingBox.height);
+    hash = Clay__HashLayerPointer(hash, command->userData);
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    hash = Clay__HashSizingFloat(hash, command->clipRect.x);
+    hash = Clay__HashSizingFloat(hash, command->clipRect.y);
+    hash = Clay__HashSizingFloat(hash, command->clipRect.width);
+    hash = Clay__HashSizingFloat(hash, command->clipRect.height);
+    hash = Clay__HashLayerColor(hash, command->overlayColor);
+    #endif
+    switch (command->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_RECTANGLE: {
+            hash = Clay__HashLayerColor(hash, data->rectangle.backgroundColor);
+            return Clay__HashLayerCornerRadius(hash, data->rectangle.cornerRadius);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_BORDER: {
+            hash = Clay__HashLayerColor(hash, data->border.color);
+            hash = Clay__HashLayerCornerRadius(hash, data->border.cornerRadius);
+            hash = Clay__HashSizingValue(hash, data->border.width.left | (uint32_t)data->border.width.right << 16);
+            hash = Clay__HashSizingValue(hash, data->border.width.top | (uint32_t)data->border.width.bottom << 16);
+            return Clay__HashSizingValue(hash, data->border.width.betweenChildren);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: {
+            Clay_StringSlice text = data->text.stringContents;
+            hash = Clay__HashLayerColor(hash, data->text.textColor);
+            hash = Clay__HashSizingValue(hash, data->text.fontId | (uint32_t)data->text.fontSize << 16);
+            hash = Clay__HashSizingValue(hash, data->text.letterSpacing | (uint32_t)data->text.lineHeight << 16);
+            hash = Clay__HashSizingValue(hash, (uint32_t)text.length);
+            for (int32_t i = 0; i < text.length; ++i) {
+                hash = Clay__HashSizingValue(hash, (uint8_t)text.chars[i]);
+            }
+            return hash;
+        }
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: {
+            hash = Clay__HashLayerColor(hash, data->image.backgroundColor);
+            hash = Clay__HashLayerCornerRadius(hash, data->image.cornerRadius);
+            return Clay__HashLayerPointer(hash, data->image.imageData);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+            hash = Clay__HashLayerColor(hash, data->custom.backgroundColor);
+            hash = Clay__HashLayerCornerRadius(hash, data->custom.cornerRadius);
+            return Clay__HashLayerPointer(hash, data->custom.customData);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+            return Clay__HashSizingValue(hash, data->clip.horizontal | (uint32_t)data->clip.vertical << 1);
+        }
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START: {
+            return Clay__HashLayerColor(hash, data->overlayColor.color);
+        }
+        default: return hash;
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_GetRenderLayers")
+int32_t Clay_GetRenderLayers(Clay_RenderCommandArray renderCommands, Clay_RenderLayer *layers, int32_t maxLayerCount) {
+    int32_t layerCount = 0;
+    Clay_RenderLayer layer = CLAY__DEFAULT_STRUCT;
+    bool hasBoundingBox = false;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *command = &renderCommands.internalArray[i];
+        if (layer.commandCount == 0 || command->zIndex != layer.zIndex) {
+            if (layer.commandCount > 0) {
+                if (layerCount < maxLayerCount) {
+                    layers[layerCount] = layer;
+                }
+                layerCount++;
+            }
+            layer = CLAY__INIT(Clay_RenderLayer) { .zIndex = command->zIndex, .firstCommand = i, .hash = 14695981039346656037ULL };
+            hasBoundingBox = false;
+        }
+        layer.commandCount++;
+        layer.hash = Clay__HashRenderCommand(layer.hash, command);
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE:
+            case CLAY_RENDER_COMMAND_TYPE_CUSTOM: {
+                Clay_BoundingBox box = command->boundingBox;
+                if (!hasBoundingBox) {
+                    layer.boundingBox = box;
+                    hasBoundingBox = true;
+                } else {
+                    float right = CLAY__MAX(layer.boundingBox.x + layer.boundingBox.width, box.x + box.width);
+                    float bottom = CLAY__MAX(layer.boundingBox.y + layer.boundingBox.height, box.y + box.height);
+                    layer.boundingBox.x = CLAY__MIN(layer.boundingBox.x, box.x);
+                    layer.boundingBox.y = CLAY__MIN(layer.boundingBox.y, box.y);
+                    layer.boundingBox.width = right - layer.boundingBox.x;
+                    layer.boundingBox.height = bottom - layer.boundingBox.y;
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+    if (layer.commandCount > 0) {
+        if (layerCount < maxLayerCount) {
+            layers[layerCount] = layer;
+        }
+        layerCount++;
+    }
+    return layerCount;
+}
+
+bool Clay__IsBatchBarrier(Clay_RenderCommand *command) {
+    switch (command->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END:
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_START:
+        case CLAY_RENDER_COMMAND_TYPE_OVERLAY_COLOR_END: return true;
+        default: return false;
     }
+}
+
+bool Clay__BatchAccepts(Clay_RenderCommandBatch *batch, Clay_RenderCommand *command) {
+    if (batch->commandType != command->commandType) {
+        return false;
+    }
+    #ifdef CLAY_RESOLVED_CLIP_RECTS
+    if (!Clay__MemCmp((const char *)&batch->clipRect, (const char *)&command->clipRect, sizeof(Clay_BoundingBox))
+        || !Clay__MemCmp((const char *)&batch->overlayColor, (const char *)&command->overlayColor, sizeof(Clay_Color))) {
+        return false;
+    }
+    #endif
+    switch (command->commandType) {
+        case CLAY_RENDER_COMMAND_TYPE_TEXT: return batch->fontId == command->renderData.text.fontId;
+        case CLAY_RENDER_COMMAND_TYPE_IMAGE: return batch->imageData == command->renderData.image.imageData;
+        default: return true;
+    }
+}
+
+// Boxes that only share an edge still count as overlapping, as anti-aliasing can blend both into the pixels along the edge
+bool Clay__BoundingBoxesTouch(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+// Assigns each command to the earliest batch it can join: the most recent batch of the current scope that accepts it, as long as it
+// doesn't touch any of the batches drawn after that one. Assignment only depends on the order of the commands, so the second pass
+// (output != NULL) replays the first pass exactly and scatters each command to its batch's range.
+bool Clay__AssignRenderCommandBatches(Clay_RenderCommandArray renderCommands, Clay_RenderCommand *output, Clay_RenderCommandBatch *batches, int32_t maxBatchCount, int32_t *batchCount) {
+    int32_t scopeStart = 0;
+    *batchCount = 0;
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *command = &renderCommands.internalArray[i];
+        if (Clay__IsBatchBarrier(command) || (i > 0 && command->zIndex != renderCommands.internalArray[i - 1].zIndex)) {
+            scopeStart = *batchCount;
+        }
+        int32_t batchIndex = -1;
+        for (int32_t j = *batchCount - 1; j >= scopeStart; --j) {
+            if (Clay__BatchAccepts(&batches[j], command)) {
+                batchIndex = j;
+                break;
+            }
+            if (Clay__BoundingBoxesTouch(batches[j].boundingBox, command->boundingBox)) {
+                break;
+            }
+        }
+        if (batchIndex == -1) {
+            if (*batchCount == maxBatchCount) {
+                return false;
+            }
+            batchIndex = (*batchCount)++;
+            if (!output) {
+                batches[batchIndex] = CLAY__INIT(Clay_RenderCommandBatch) {
+                    .commandType = command->commandType,
+                    .fontId = command->commandType == CLAY_RENDER_COMMAND_TYPE_TEXT ? command->renderData.text.fontId : (uint16_t)0,
+                    .imageData = command->commandType == CLAY_RENDER_COMMAND_TYPE_IMAGE ? command->renderData.image.imageData : CLAY__NULL,
+                };
+                CLAY__RESOLVE(batches[batchIndex].clipRect = command->clipRect);
+                CLAY__RESOLVE(batches[batchIndex].overlayColor = command->overlayColor);
+            }
+            batches[batchIndex].commandCount = 0;
+        }
+        Clay_RenderCommandBatch *batch = &batches[batchIndex];
+        if (batch->commandCount == 0) {
+            batch->boundingBox = command->boundingBox;
+        } else {
+            Clay_BoundingBox box = command->boundingBox;
+            float right = CLAY__MAX(batch->boundingBox.x + batch->boundingBox.width, box.x + box.width);
+            float bottom = CLAY__MAX(batch->boundingBox.y + batch->boundingBox.height, box.y + box.height);
+            batch->boundingBox.x = CLAY__MIN(batch->boundingBox.x, box.x);
+            batch->boundingBox.y = CLAY__MIN(batch->boundingBox.y, box.y);
+            batch->boundingBox.width = right - batch->boundingBox.x;
+            batch->boundingBox.height = bottom - batch->boundingBox.y;
+        }
+        if (output) {
+            output[batch->firstCommand + batch->commandCount] = *command;
+        }
+        batch->commandCount++;
+        if (Clay__IsBatchBarrier(command)) {
+            scopeStart = *batchCount;
+        }
+    }
+    return true;
+}
+
+CLAY_WASM_EXPORT("Clay_BatchRenderCommands")
+int32_t Clay_BatchRenderCommands(Clay_RenderCommandArray renderCommands, Clay_RenderCommand *output, Clay_RenderCommandBatch *batches, int32_t maxBatchCount) {
+    int32_t batchCount = 0;
+    if (!Clay__AssignRenderCommandBatches(renderCommands, CLAY__NULL, batches, maxBatchCount, &batchCount)) {
+        for (int32_t i = 0; i < renderCommands.length; ++i) {
+            output[i] = renderCommands.internalArray[i];
+        }
+        return -1;
+    }
+    int32_t firstCommand = 0;
+    for (int32_t i = 0; i < batchCount; ++i) {
+        batches[i].firstCommand = firstCommand;
+        firstCommand += batches[i].commandCount;
+    }
+    Clay__AssignRenderCommandBatches(renderCommands, output, batches, maxBatchCount, &batchCount);
+    return batchCount;
+}
+
+// Only the largest occluders are kept, as small opaque rectangles rarely cover anything else
+#define CLAY__MAX_OCCLUDER_COUNT 32
+
+typedef struct Clay__Occluder {
+    Clay_BoundingBox boundingBox;
+    // The number of enclosing scissors whose SCISSOR_START hasn't been reached yet, as commands are visited in reverse
+    int32_t scissorDepth;
+} Clay__Occluder;
+
+bool Clay__BoundingBoxContains(Clay_BoundingBox outer, Clay_BoundingBox inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+}
+
+CLAY_WASM_EXPORT("Clay_CullOccludedRenderCommands")
+int32_t Clay_CullOccludedRenderCommands(Clay_RenderCommandArray *renderCommands) {
+    Clay__Occluder occluders[CLAY__MAX_OCCLUDER_COUNT];
+    int32_t occluderCount = 0;
+    int32_t scissorDepth = 0;
+    // Commands are visited last to first so that every occluder is known before the commands it covers. Kept commands are packed
+    // towards the end of the array and moved back to the start afterwards.
+    int32_t keptStart = renderCommands->length;
+    for (int32_t i = renderCommands->length - 1; i >= 0; --i) {
+        Clay_RenderCommand *command = &renderCommands->internalArray[i];
+        bool removable = false;
+        switch (command->commandType) {
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_END: {
+                scissorDepth++;
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_SCISSOR_START: {
+                if (scissorDepth == 0) {
+                    break;
+                }
+                // Occluders inside this scissor are now known to be clipped by it
+                for (int32_t j = 0; j < occluderCount; ++j) {
+                    if (occluders[j].scissorDepth >= scissorDepth) {
+                        occluders[j].boundingBox = Clay__IntersectClipRect(occluders[j].boundingBox, command->boundingBox, true, true);
+                        occluders[j].scissorDepth = scissorDepth - 1;
+                    }
+                }
+                scissorDepth--;
+                break;
+            }
+            case CLAY_RENDER_COMMAND_TYPE_RECTANGLE:
+            case CLAY_RENDER_COMMAND_TYPE_BORDER:
+            case CLAY_RENDER_COMMAND_TYPE_TEXT:
+            case CLAY_RENDER_COMMAND_TYPE_IMAGE: removable = true; break;
+            default: break;
+        }
+        Clay_BoundingBox visibleBox = command->boundingBox;
+        CLAY__RESOLVE(visibleBox = Clay__IntersectClipRect(visibleBox, command->clipRect, true, true));
+        bool occluded = false;
+        for (int32_t j = 0; j < occluderCount && removable && !occluded; ++j) {
+            // An occluder that is still waiting on some of its scissors is only compared against commands inside exactly the same scissors,
+            // which keeps the result correct for renderers that don't intersect nested scissors
+            if (occluders[j].scissorDepth == 0 || occluders[j].scissorDepth == scissorDepth) {
+                occluded = Clay__BoundingBoxContains(occluders[j].boundingBox, visibleBox);
+            }
+        }
+        if (occluded) {
+            continue;
+        }
+        renderCommands->internalArray[--keptStart] = *command;
+        Clay_RectangleRenderData *rectangle = &command->renderData.rectangle;
+        if (command->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE && rectangle->backgroundColor.a >= 255
+            && rectangle->cornerRadius.topLeft == 0 && rectangle->cornerRadius.topRight == 0 && rectangle->cornerRadius.bottomLeft == 0 && rectangle->cornerRadius.bottomRight == 0) {
+            Clay__Occluder occluder = { visibleBox, scissorDepth };
+            float area = visibleBox.width * visibleBox.height;
+            if (occluderCount < CLAY__MAX_OCCLUDER_COUNT) {
+                occluders[occluderCount++] = occluder;
+            } else {
+                int32_t smallest = 0;
+                for (int32_t j = 1; j < occluderCount; ++j) {
+                    if (occluders[j].boundingBox.width * occluders[j].boundingBox.height < occluders[smallest].boundingBox.width * occluders[smallest].boundingBox.height) {
+                        smallest = j;
+                    }
+                }
+                if (occluders[smallest].boundingBox.width * occluders[smallest].boundingBox.height < area) {
+                    occluders[smallest] = occluder;
+                }
+            }
+        }
+    }
+    int32_t removedCount = keptStart;
+    for (int32_t i = keptStart; i < renderCommands->length; ++i) {
+        renderCommands->internalArray[i - removedCount] = renderCommands->internalArray[i];
+    }
+    renderCommands->length -= removedCount;
+    return removedCount;
+}
+
+#ifdef CLAY_RECORDING
+CLAY_WASM_EXPORT("Clay_SetRecorder")
+void Clay_SetRecorder(Clay_Recorder recorder) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__FlushRecordBuffer(context);
+    context->recorder = recorder;
+    context->recordingHeaderWritten = false;
+    // The recording starts with the current layout dimensions, as they may have been set by Clay_Initialize()
+    if (Clay__RecordEvent(context, CLAY__RECORD_EVENT_TYPE_LAYOUT_DIMENSIONS)) {
+        Clay__RecordFloat(context, context->layoutDimensions.width);
+        Clay__RecordFloat(context, context->layoutDimensions.height);
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_FlushRecorder")
+void Clay_FlushRecorder(void) {
+    Clay__FlushRecordBuffer(Clay_GetCurrentContext());
+}
+#endif
+
+#ifdef CLAY_TRACING
+typedef struct {
+    char *buffer;
+    size_t capacity;
+    size_t length;
+} Clay__TraceWriter;
+
+void Clay__TraceWriteChar(Clay__TraceWriter *writer, char c) {
+    if (writer->length < writer->capacity) {
+        writer->buffer[writer->length] = c;
+    }
+    writer->length++;
+}
+
+void Clay__TraceWriteString(Clay__TraceWriter *writer, Clay_String string) {
+    for (int32_t i = 0; i < string.length; ++i) {
+        Clay__TraceWriteChar(writer, string.chars[i]);
+    }
+}
+
+void Clay__TraceWriteUInt(Clay__TraceWriter *writer, uint64_t value, int32_t minDigits) {
+    char digits[20];
+    int32_t digitCount = 0;
+    do {
+        digits[digitCount++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 || digitCount < minDigits);
+    while (digitCount > 0) {
+        Clay__TraceWriteChar(writer, digits[--digitCount]);
+    }
+}
+
+CLAY_WASM_EXPORT("Clay_TraceBufferSize")
+size_t Clay_TraceBufferSize(int32_t eventCount) {
+    // Extra space to align the start of the buffer
+    return (size_t)eventCount * sizeof(Clay__TraceEvent) + 64;
+}
+
+CLAY_WASM_EXPORT("Clay_SetTraceBuffer")
+void Clay_SetTraceBuffer(void *memory, size_t size) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    context->traceEvents = NULL;
+    context->traceEventCapacity = 0;
+    context->traceEventCount = 0;
+    if (!memory) {
+        return;
+    }
+    uintptr_t alignment = (64 - ((uintptr_t)memory % 64)) & 63;
+    if (size < alignment + sizeof(Clay__TraceEvent)) {
+        return;
+    }
+    context->traceEvents = (Clay__TraceEvent *)((char *)memory + alignment);
+    context->traceEventCapacity = (int32_t)CLAY__MIN((size - alignment) / sizeof(Clay__TraceEvent), (size_t)INT32_MAX);
+}
+
+CLAY_WASM_EXPORT("Clay_WriteTraceJSON")
+size_t Clay_WriteTraceJSON(char *buffer, size_t bufferSize) {
+    Clay_Context* context = Clay_GetCurrentContext();
+    Clay__TraceWriter writer = { buffer, bufferSize, 0 };
+    Clay__TraceWriteString(&writer, CLAY_STRING("{\"traceEvents\":["));
+    uint64_t firstEvent = context->traceEventCount > (uint64_t)context->traceEventCapacity ? context->traceEventCount - context->traceEventCapacity : 0;
+    int32_t depth = 0;
+    bool eventWritten = false;
+    for (uint64_t i = firstEvent; i < context->traceEventCount; ++i) {
+        Clay__TraceEvent *event = &context->traceEvents[i % (uint64_t)context->traceEventCapacity];
+        // Once the ring buffer has wrapped, the begin events of the oldest scopes may have been overwritten, skip their end events
+        if (event->type == CLAY__TRACE_EVENT_TYPE_END) {
+            if (depth == 0) {
+                continue;
+            }
+            depth--;
+        } else if (event->type == CLAY__TRACE_EVENT_TYPE_BEGIN) {
+            depth++;
+        }
+        if (eventWritten) {
+            Clay__TraceWriteChar(&writer, ',');
+        }
+        eventWritten = true;
+        Clay__TraceWriteString(&writer, CLAY_STRING("\n{\"name\":\""));
+        Clay__TraceWriteString(&writer, event->name);
+        Clay__TraceWriteString(&writer, CLAY_STRING("\",\"ph\":\""));
+        Clay__TraceWriteChar(&writer, event->type == CLAY__TRACE_EVENT_TYPE_BEGIN ? 'B' : event->type == CLAY__TRACE_EVENT_TYPE_END ? 'E' : 'C');
+        // Timestamps are in microseconds
+        Clay__TraceWriteString(&writer, CLAY_STRING("\",\"ts\":"));
+        Clay__TraceWriteUInt(&writer, event->timestamp / 1000, 1);
+        Clay__TraceWriteChar(&writer, '.');
+        Clay__TraceWriteUInt(&writer, event->timestamp % 1000, 3);
+        Clay__TraceWriteString(&writer, CLAY_STRING(",\"pid\":1,\"tid\":1"));
+        if (event->argName.length > 0) {
+            Clay__TraceWriteString(&writer, CLAY_STRING(",\"args\":{\""));
+            Clay__TraceWriteString(&writer, event->argName);
+            Clay__TraceWriteString(&writer, CLAY_STRING("\":"));
+            Clay__TraceWriteUInt(&writer, event->value, 1);
+            Clay__TraceWriteChar(&writer, '}');
+        }
+        Clay__TraceWriteChar(&writer, '}');
+    }
+    Clay__TraceWriteString(&writer, CLAY_STRING("\n]}\n"));
+    return writer.length;
+}
+#endif
+
+bool Clay__EvaluateBuiltInTransition(Clay__TransitionCurve curve, Clay_TransitionCallbackArguments *arguments) {
+    float ratio = Clay__TransitionRatio(arguments->elapsedTime, arguments->duration);
+    float lerpAmount;
+    Clay__EvaluateTransitionCurve(curve, &ratio, &lerpAmount, 1);
+    Clay__LerpTransitionData(arguments->current, &arguments->initial, &arguments->target, arguments->properties, lerpAmount);
     return ratio >= 1;
 }
 
+CLAY_DLL_EXPORT bool Clay_EaseOut(Clay_TransitionCallbackArguments arguments) {
+    return Clay__EvaluateBuiltInTransition(CLAY__TRANSITION_CURVE_EASE_OUT, &arguments);
+}
+
+CLAY_DLL_EXPORT bool Clay_EaseInOut(Clay_TransitionCallbackArguments arguments) {
+    return Clay__EvaluateBuiltInTransition(CLAY__TRANSITION_CURVE_EASE_IN_OUT, &arguments);
+}
+
+CLAY_DLL_EXPORT bool Clay_Spring(Clay_TransitionCallbackArguments arguments) {
+    return Clay__EvaluateBuiltInTransition(CLAY__TRANSITION_CURVE_SPRING, &arguments);
+}
+
 #endif // CLAY_IMPLEMENTATION
 
 /*
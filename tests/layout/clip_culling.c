@@ -0,0 +1,85 @@
+// Regression tests for render command culling against clip rects. Exits with a non zero status if any check fails.
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int32_t Test_FailureCount = 0;
+
+#define TEST_CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Test_FailureCount++; } } while (0)
+
+Clay_Dimensions Test_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.5f, .height = (float)config->fontSize };
+}
+
+void Test_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    Test_FailureCount++;
+}
+
+Clay_RenderCommand *Test_FindRenderCommand(Clay_RenderCommandArray renderCommands, Clay_ElementId id) {
+    for (int32_t i = 0; i < renderCommands.length; ++i) {
+        Clay_RenderCommand *renderCommand = Clay_RenderCommandArray_Get(&renderCommands, i);
+        if (renderCommand->id == id.id && renderCommand->commandType == CLAY_RENDER_COMMAND_TYPE_RECTANGLE) {
+            return renderCommand;
+        }
+    }
+    return NULL;
+}
+
+// A child that overflows a parent which is scrolled out of view is still visible, and must not be culled with its parent
+void Test_OverflowingChildOfCulledParent(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("ScrollContainer"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(200) } }, .clip = { .vertical = true, .childOffset = { 0, -100 } } }) {
+        CLAY(CLAY_ID("Header"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(20) } }, .backgroundColor = { 255, 0, 0, 255 } }) {
+            CLAY(CLAY_ID("Overflow"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(300) } }, .backgroundColor = { 0, 255, 0, 255 } }) {}
+        }
+    }
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout(0);
+
+    TEST_CHECK(Test_FindRenderCommand(renderCommands, CLAY_ID("Header")) == NULL);
+    Clay_RenderCommand *overflow = Test_FindRenderCommand(renderCommands, CLAY_ID("Overflow"));
+    TEST_CHECK(overflow != NULL);
+    if (overflow) {
+        TEST_CHECK(overflow->boundingBox.x == 0 && overflow->boundingBox.y == -100);
+        TEST_CHECK(overflow->boundingBox.width == 400 && overflow->boundingBox.height == 300);
+    }
+}
+
+// Children of a clip container that are entirely outside of it are culled
+void Test_ChildOutsideClipContainer(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("ScrollContainer"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(200) }, .layoutDirection = CLAY_TOP_TO_BOTTOM }, .clip = { .vertical = true, .childOffset = { 0, -100 } } }) {
+        CLAY(CLAY_ID("Above"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(50) } }, .backgroundColor = { 255, 0, 0, 255 } }) {}
+        CLAY(CLAY_ID("Visible"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(100) } }, .backgroundColor = { 0, 255, 0, 255 } }) {}
+        CLAY(CLAY_ID("Below"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(400) } }, .backgroundColor = { 0, 0, 255, 255 } }) {
+            CLAY(CLAY_ID("BelowChild"), { .layout = { .sizing = { CLAY_SIZING_FIXED(400), CLAY_SIZING_FIXED(50) } }, .backgroundColor = { 0, 0, 255, 255 } }) {}
+        }
+    }
+    Clay_RenderCommandArray renderCommands = Clay_EndLayout(0);
+
+    TEST_CHECK(Test_FindRenderCommand(renderCommands, CLAY_ID("Above")) == NULL);
+    TEST_CHECK(Test_FindRenderCommand(renderCommands, CLAY_ID("Visible")) != NULL);
+    TEST_CHECK(Test_FindRenderCommand(renderCommands, CLAY_ID("Below")) != NULL);
+    TEST_CHECK(Test_FindRenderCommand(renderCommands, CLAY_ID("BelowChild")) != NULL);
+}
+
+int main(void) {
+    uint32_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 800, 600 }, (Clay_ErrorHandler) { Test_HandleError });
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+
+    Test_OverflowingChildOfCulledParent();
+    Test_ChildOutsideClipContainer();
+
+    if (Test_FailureCount > 0) {
+        fprintf(stderr, "%d checks failed\n", Test_FailureCount);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
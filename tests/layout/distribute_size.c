@@ -0,0 +1,397 @@
+// Compares Clay__DistributeSize against the loop it replaced, which repeatedly grew the smallest (or shrank the largest)
+// resizable children until the remaining space was below CLAY__EPSILON. Randomized sets of GROW siblings with min and max
+// sizes are distributed both ways, growing and shrinking along both axes, including sets of thousands of siblings. Randomized
+// nested layouts with text, and a row of thousands of GROW and text siblings, are also run through the whole layout
+// pass once with each distribution and their bounding boxes compared.
+// Exits with a non zero status if any check fails.
+//
+// Note: the reference loop leaves up to CLAY__EPSILON of space undistributed, so sizes only agree within that tolerance.
+// Transitions restart when an element's target moves by CLAY__EPSILON or more, so when transitions are active that leftover
+// can restart a position transition with the reference loop that doesn't restart with the exact distribution, and
+// intermediate frames of the two can differ by several pixels until both transitions settle on the same target.
+
+#include <stdbool.h>
+
+// Clay__SizeContainersAlongAxis calls this instead of Clay__DistributeSize, so that layouts can be run with either
+void Test_DistributeSize(void *resizableContainerBuffer, bool xAxis, bool shrink, float sizeToDistribute);
+#define CLAY__DISTRIBUTE_SIZE Test_DistributeSize
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_CASE_COUNT 20000
+#define TEST_MAX_SIBLING_COUNT 32
+#define TEST_LARGE_CASE_COUNT 4
+#define TEST_LARGE_SIBLING_COUNT 3000
+#define TEST_LAYOUT_CASE_COUNT 2000
+#define TEST_MAX_LAYOUT_DEPTH 4
+#define TEST_MAX_LAYOUT_NODE_COUNT 256
+#define TEST_TOLERANCE (CLAY__EPSILON * 1.5f)
+// Every level of nesting can leave up to CLAY__EPSILON of its parent's space undistributed with the reference loop
+#define TEST_LAYOUT_TOLERANCE (CLAY__EPSILON * (TEST_MAX_LAYOUT_DEPTH + 1))
+// Positions are running float sums of the preceding siblings' sizes, which round differently when those sizes differ slightly.
+// Thousands of siblings hundreds of thousands of pixels along a row accumulate about 1e-5 of the position that way.
+#define TEST_POSITION_TOLERANCE 1e-5f
+#define TEST_TEXT_STORAGE_LENGTH 4096
+#define TEST_MAX_TEXT_LENGTH 60
+#define TEST_CHARACTER_WIDTH 7.3f
+
+int32_t Test_FailureCount = 0;
+uint32_t Test_RandomState = 1;
+bool Test_UseReference = false;
+int32_t Test_NodeCount = 0;
+char Test_Text[TEST_TEXT_STORAGE_LENGTH];
+
+#define TEST_CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Test_FailureCount++; } } while (0)
+
+void Test_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    Test_FailureCount++;
+}
+
+int32_t Test_Random(int32_t range) {
+    Test_RandomState = Test_RandomState * 1103515245 + 12345;
+    return (int32_t)((Test_RandomState >> 16) % (uint32_t)range);
+}
+
+float *Test_Size(Clay_LayoutElement *element, bool xAxis) {
+    return xAxis ? &element->dimensions.width : &element->dimensions.height;
+}
+
+// The distribution loops from Clay__SizeContainersAlongAxis before they were replaced by Clay__DistributeSize, with two changes
+// that only matter for thousands of siblings:
+// - The original loops tracked the remaining space in a float. Subtracting each sibling's change from a remaining space of
+//   hundreds of thousands of pixels rounds away more than CLAY__EPSILON over a distribution, so the old loops distributed
+//   noticeably more or less space than they were given. The reference tracks it in a double instead.
+// - Once the remaining space split between the siblings is below the float precision of their sizes, adding it no longer
+//   changes them and the original loops never terminated, so the reference stops when an iteration changes nothing.
+void Test_DistributeSizeReference(Clay__int32_tArray *resizableContainerBuffer, bool xAxis, bool shrink, float totalSizeToDistribute) {
+    Clay_Context *context = Clay_GetCurrentContext();
+    double sizeToDistribute = totalSizeToDistribute;
+    if (shrink) {
+        sizeToDistribute = -sizeToDistribute;
+        while (sizeToDistribute < -CLAY__EPSILON && resizableContainerBuffer->length > 0) {
+            int32_t previousLength = resizableContainerBuffer->length;
+            bool sizeChanged = false;
+            float largest = 0;
+            float secondLargest = 0;
+            float widthToAdd = sizeToDistribute;
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                float childSize = *Test_Size(Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(resizableContainerBuffer, childIndex)), xAxis);
+                if (Clay__FloatEqual(childSize, largest)) { continue; }
+                if (childSize > largest) {
+                    secondLargest = largest;
+                    largest = childSize;
+                }
+                if (childSize < largest) {
+                    secondLargest = CLAY__MAX(secondLargest, childSize);
+                    widthToAdd = secondLargest - largest;
+                }
+            }
+            widthToAdd = CLAY__MAX(widthToAdd, sizeToDistribute / resizableContainerBuffer->length);
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(resizableContainerBuffer, childIndex));
+                float *childSize = Test_Size(child, xAxis);
+                float minSize = xAxis ? child->minDimensions.width : child->minDimensions.height;
+                float previousWidth = *childSize;
+                if (Clay__FloatEqual(*childSize, largest)) {
+                    *childSize += widthToAdd;
+                    if (*childSize <= minSize) {
+                        *childSize = minSize;
+                        Clay__int32_tArray_RemoveSwapback(resizableContainerBuffer, childIndex--);
+                    }
+                    sizeToDistribute -= (*childSize - previousWidth);
+                    sizeChanged = sizeChanged || *childSize != previousWidth;
+                }
+            }
+            if (!sizeChanged && resizableContainerBuffer->length == previousLength) {
+                break;
+            }
+        }
+    } else {
+        while (sizeToDistribute > CLAY__EPSILON && resizableContainerBuffer->length > 0) {
+            int32_t previousLength = resizableContainerBuffer->length;
+            bool sizeChanged = false;
+            float smallest = CLAY__MAXFLOAT;
+            float secondSmallest = CLAY__MAXFLOAT;
+            float widthToAdd = sizeToDistribute;
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                float childSize = *Test_Size(Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(resizableContainerBuffer, childIndex)), xAxis);
+                if (Clay__FloatEqual(childSize, smallest)) { continue; }
+                if (childSize < smallest) {
+                    secondSmallest = smallest;
+                    smallest = childSize;
+                }
+                if (childSize > smallest) {
+                    secondSmallest = CLAY__MIN(secondSmallest, childSize);
+                    widthToAdd = secondSmallest - smallest;
+                }
+            }
+            widthToAdd = CLAY__MIN(widthToAdd, sizeToDistribute / resizableContainerBuffer->length);
+            for (int childIndex = 0; childIndex < resizableContainerBuffer->length; childIndex++) {
+                Clay_LayoutElement *child = Clay_LayoutElementArray_Get(&context->layoutElements, Clay__int32_tArray_GetValue(resizableContainerBuffer, childIndex));
+                float *childSize = Test_Size(child, xAxis);
+                float maxSize = Clay__GetElementSizing(child, xAxis).size.minMax.max;
+                float previousWidth = *childSize;
+                if (Clay__FloatEqual(*childSize, smallest)) {
+                    *childSize += widthToAdd;
+                    if (*childSize >= maxSize) {
+                        *childSize = maxSize;
+                        Clay__int32_tArray_RemoveSwapback(resizableContainerBuffer, childIndex--);
+                    }
+                    sizeToDistribute -= (*childSize - previousWidth);
+                    sizeChanged = sizeChanged || *childSize != previousWidth;
+                }
+            }
+            if (!sizeChanged && resizableContainerBuffer->length == previousLength) {
+                break;
+            }
+        }
+    }
+}
+
+void Test_DistributeSize(void *resizableContainerBuffer, bool xAxis, bool shrink, float sizeToDistribute) {
+    if (Test_UseReference) {
+        Test_DistributeSizeReference(resizableContainerBuffer, xAxis, shrink, sizeToDistribute);
+    } else {
+        Clay__DistributeSize(resizableContainerBuffer, xAxis, shrink, sizeToDistribute);
+    }
+}
+
+// Creates siblings with random GROW min and max sizes. As in clay's own layout, the current size and min size of every
+// sibling lie between its sizing min and max, and when growing siblings start at their min size.
+void Test_CreateSiblings(Clay_Context *context, int32_t siblingCount, bool xAxis, bool shrink) {
+    context->layoutElements.length = siblingCount;
+    for (int32_t i = 0; i < siblingCount; ++i) {
+        float min = Test_Random(3) == 0 ? 0 : (float)Test_Random(120) + (float)Test_Random(100) / 100.0f;
+        float max = Test_Random(3) == 0 ? min + (float)Test_Random(300) : CLAY__MAXFLOAT;
+        float contentSize = CLAY__MIN(min + (float)Test_Random(400) + (float)Test_Random(100) / 100.0f, max);
+        Clay_LayoutElement element = CLAY__DEFAULT_STRUCT;
+        Clay_SizingAxis sizing = { .size = { .minMax = { min, max } }, .type = CLAY__SIZING_TYPE_GROW };
+        if (xAxis) {
+            element.config.layout.sizing.width = sizing;
+            element.minDimensions.width = min;
+            element.dimensions.width = shrink ? contentSize : min;
+        } else {
+            element.config.layout.sizing.height = sizing;
+            element.minDimensions.height = min;
+            element.dimensions.height = shrink ? contentSize : min;
+        }
+        *Clay_LayoutElementArray_Get(&context->layoutElements, i) = element;
+    }
+}
+
+void Test_CompareDistributions(int32_t testCase, int32_t siblingCount) {
+    Clay_Context *context = Clay_GetCurrentContext();
+    bool xAxis = Test_Random(2) == 0;
+    bool shrink = Test_Random(2) == 0;
+    Test_CreateSiblings(context, siblingCount, xAxis, shrink);
+
+    static float initialSizes[TEST_LARGE_SIBLING_COUNT];
+    static float referenceSizes[TEST_LARGE_SIBLING_COUNT];
+    static int32_t indices[TEST_LARGE_SIBLING_COUNT];
+    float sizeToDistribute = 0;
+    float initialTotal = 0;
+    for (int32_t i = 0; i < siblingCount; ++i) {
+        Clay_LayoutElement *element = Clay_LayoutElementArray_Get(&context->layoutElements, i);
+        initialSizes[i] = *Test_Size(element, xAxis);
+        initialTotal += initialSizes[i];
+        // Sometimes distribute more than the siblings can take, so that every sibling reaches its limit
+        float range = shrink ? initialSizes[i] - (xAxis ? element->minDimensions.width : element->minDimensions.height) : 300;
+        sizeToDistribute += range * (float)Test_Random(120) / 100.0f;
+    }
+    sizeToDistribute = CLAY__MAX(sizeToDistribute, 1);
+
+    for (int32_t i = 0; i < siblingCount; ++i) {
+        indices[i] = i;
+    }
+    Clay__int32_tArray buffer = { .capacity = TEST_LARGE_SIBLING_COUNT, .length = siblingCount, .internalArray = indices };
+    Test_DistributeSizeReference(&buffer, xAxis, shrink, sizeToDistribute);
+    for (int32_t i = 0; i < siblingCount; ++i) {
+        float *size = Test_Size(Clay_LayoutElementArray_Get(&context->layoutElements, i), xAxis);
+        referenceSizes[i] = *size;
+        *size = initialSizes[i];
+        indices[i] = i;
+    }
+
+    buffer.length = siblingCount;
+    Clay__DistributeSize(&buffer, xAxis, shrink, sizeToDistribute);
+    float total = 0;
+    bool allAtLimit = true;
+    for (int32_t i = 0; i < siblingCount; ++i) {
+        Clay_LayoutElement *element = Clay_LayoutElementArray_Get(&context->layoutElements, i);
+        float size = *Test_Size(element, xAxis);
+        float limit = shrink ? (xAxis ? element->minDimensions.width : element->minDimensions.height) : Clay__GetElementSizing(element, xAxis).size.minMax.max;
+        float difference = size - referenceSizes[i];
+        if (difference > TEST_TOLERANCE || difference < -TEST_TOLERANCE) {
+            fprintf(stderr, "case %d: sibling %d of %d is %f, reference is %f\n", (int)testCase, (int)i, (int)siblingCount, (double)size, (double)referenceSizes[i]);
+            Test_FailureCount++;
+        }
+        allAtLimit = allAtLimit && Clay__FloatEqual(size, limit);
+        total += size;
+    }
+    // Unlike the reference, the distribution is exact unless every sibling has reached its limit
+    if (!allAtLimit) {
+        float expectedTotal = initialTotal + (shrink ? -sizeToDistribute : sizeToDistribute);
+        float error = total - expectedTotal;
+        TEST_CHECK(error < 0.001f * CLAY__MAX(1, expectedTotal) && error > -0.001f * CLAY__MAX(1, expectedTotal));
+    }
+}
+
+// Wrapped text is as tall as its line count, so a width that differs from the reference's by less than the tolerance could
+// move a line break and change heights by a whole line. Text here has no height, so only its widths are compared.
+Clay_Dimensions Test_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * TEST_CHARACTER_WIDTH, .height = 0 };
+}
+
+// A random slice of Test_Text, which holds words of random lengths separated by single spaces
+Clay_String Test_RandomText(void) {
+    int32_t length = 1 + Test_Random(TEST_MAX_TEXT_LENGTH);
+    return (Clay_String) { .length = length, .chars = Test_Text + Test_Random(TEST_TEXT_STORAGE_LENGTH - length) };
+}
+
+Clay_SizingAxis Test_RandomSizing(bool hasChildren) {
+    float min = Test_Random(2) == 0 ? 0 : (float)Test_Random(80);
+    float max = Test_Random(3) == 0 ? min + (float)Test_Random(200) : CLAY__MAXFLOAT;
+    switch (Test_Random(3)) {
+        case 0: return CLAY_SIZING_GROW(min, max);
+        // Leaves have no content, so a FIT leaf is just its min size
+        case 1: return hasChildren ? CLAY_SIZING_FIT(min, max) : CLAY_SIZING_FIXED(min);
+        default: return CLAY_SIZING_FIXED((float)Test_Random(400));
+    }
+}
+
+// Declares a random tree of GROW, FIT and FIXED containers and text, with every container given an id from its
+// declaration order
+void Test_DeclareNestedNode(int32_t depth) {
+    if (depth > 0 && Test_Random(4) == 0) {
+        CLAY_TEXT(Test_RandomText(), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        return;
+    }
+    int32_t id = Test_NodeCount++;
+    int32_t childCount = depth < TEST_MAX_LAYOUT_DEPTH ? Test_Random(7) : 0;
+    Clay_LayoutConfig layout = {
+        .sizing = { Test_RandomSizing(childCount > 0), Test_RandomSizing(childCount > 0) },
+        .padding = { (uint16_t)Test_Random(8), (uint16_t)Test_Random(8), (uint16_t)Test_Random(8), (uint16_t)Test_Random(8) },
+        .childGap = (uint16_t)Test_Random(8),
+        .layoutDirection = Test_Random(2) == 0 ? CLAY_LEFT_TO_RIGHT : CLAY_TOP_TO_BOTTOM,
+    };
+    CLAY(CLAY_IDI("Node", id), { .layout = layout }) {
+        for (int32_t i = 0; i < childCount && Test_NodeCount < TEST_MAX_LAYOUT_NODE_COUNT; ++i) {
+            Test_DeclareNestedNode(depth + 1);
+        }
+    }
+}
+
+void Test_DeclareNestedLayout(void) {
+    Test_DeclareNestedNode(0);
+}
+
+// A row of TEST_LARGE_SIBLING_COUNT siblings, each either a GROW leaf with distinct min and max sizes or a text element,
+// which can shrink down to its longest word. The parent is sized between a third and twice the siblings' content,
+// so that the text is sometimes shrunk and the GROW leaves are sometimes grown, down to their min or up to their max size.
+void Test_DeclareLargeLayout(void) {
+    static bool isText[TEST_LARGE_SIBLING_COUNT];
+    static Clay_SizingAxis sizing[TEST_LARGE_SIBLING_COUNT];
+    static Clay_String text[TEST_LARGE_SIBLING_COUNT];
+    float contentSize = 0;
+    for (int32_t i = 0; i < TEST_LARGE_SIBLING_COUNT; ++i) {
+        isText[i] = Test_Random(2) == 0;
+        if (isText[i]) {
+            text[i] = Test_RandomText();
+            contentSize += (float)text[i].length * TEST_CHARACTER_WIDTH;
+        } else {
+            float min = (float)Test_Random(50) + (float)Test_Random(100) / 100.0f;
+            float max = Test_Random(3) == 0 ? min + (float)Test_Random(200) : CLAY__MAXFLOAT;
+            sizing[i] = CLAY_SIZING_GROW(min, max);
+            contentSize += min;
+        }
+    }
+    float parentSize = contentSize * (float)(33 + Test_Random(167)) / 100.0f;
+    CLAY(CLAY_IDI("Node", Test_NodeCount++), { .layout = { .sizing = { CLAY_SIZING_FIXED(parentSize), CLAY_SIZING_GROW(0) } } }) {
+        for (int32_t i = 0; i < TEST_LARGE_SIBLING_COUNT; ++i) {
+            if (isText[i]) {
+                CLAY_TEXT(text[i], CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+            } else {
+                CLAY(CLAY_IDI("Node", Test_NodeCount++), { .layout = { .sizing = { sizing[i], CLAY_SIZING_GROW(0) } } }) {}
+            }
+        }
+    }
+}
+
+bool Test_Within(float value, float reference, float tolerance) {
+    return value - reference <= tolerance && reference - value <= tolerance;
+}
+
+bool Test_BoundingBoxesMatch(Clay_BoundingBox a, Clay_BoundingBox b) {
+    return Test_Within(a.x, b.x, TEST_LAYOUT_TOLERANCE + CLAY__MAX(b.x, -b.x) * TEST_POSITION_TOLERANCE)
+        && Test_Within(a.y, b.y, TEST_LAYOUT_TOLERANCE + CLAY__MAX(b.y, -b.y) * TEST_POSITION_TOLERANCE)
+        && Test_Within(a.width, b.width, TEST_LAYOUT_TOLERANCE)
+        && Test_Within(a.height, b.height, TEST_LAYOUT_TOLERANCE);
+}
+
+// Runs the whole layout pass over the tree from declareLayout, once with the reference loop and once with Clay__DistributeSize,
+// and compares the bounding boxes of every node
+void Test_CompareLayouts(int32_t testCase, void (*declareLayout)(void)) {
+    static Clay_BoundingBox referenceBoxes[TEST_LARGE_SIBLING_COUNT + 1];
+    uint32_t randomState = Test_RandomState;
+    for (int32_t pass = 0; pass < 2; ++pass) {
+        Test_UseReference = pass == 0;
+        Test_RandomState = randomState;
+        Test_NodeCount = 0;
+        Clay_BeginLayout();
+        declareLayout();
+        Clay_EndLayout(0);
+        // Each tree is laid out once with each distribution, so the sizes must never be restored from the previous frame
+        TEST_CHECK(!Clay_GetFrameStats().sizesReused);
+        for (int32_t i = 0; i < Test_NodeCount; ++i) {
+            Clay_ElementData data = Clay_GetElementData(CLAY_IDI("Node", i));
+            TEST_CHECK(data.found);
+            if (pass == 0) {
+                referenceBoxes[i] = data.boundingBox;
+            } else if (!Test_BoundingBoxesMatch(data.boundingBox, referenceBoxes[i])) {
+                Clay_BoundingBox reference = referenceBoxes[i];
+                fprintf(stderr, "layout %d: node %d is { %f, %f, %f, %f }, reference is { %f, %f, %f, %f }\n", (int)testCase, (int)i,
+                    (double)data.boundingBox.x, (double)data.boundingBox.y, (double)data.boundingBox.width, (double)data.boundingBox.height,
+                    (double)reference.x, (double)reference.y, (double)reference.width, (double)reference.height);
+                Test_FailureCount++;
+            }
+        }
+    }
+    Test_UseReference = false;
+}
+
+int main(void) {
+    uint32_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 800, 600 }, (Clay_ErrorHandler) { Test_HandleError });
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+    for (int32_t i = 0; i < TEST_TEXT_STORAGE_LENGTH; ++i) {
+        Test_Text[i] = i > 0 && Test_Text[i - 1] != ' ' && Test_Random(6) == 0 ? ' ' : (char)('a' + Test_Random(26));
+    }
+
+    for (int32_t testCase = 0; testCase < TEST_CASE_COUNT; ++testCase) {
+        Test_CompareDistributions(testCase, 1 + Test_Random(TEST_MAX_SIBLING_COUNT));
+    }
+    for (int32_t testCase = 0; testCase < TEST_LARGE_CASE_COUNT; ++testCase) {
+        Test_CompareDistributions(testCase, TEST_LARGE_SIBLING_COUNT);
+    }
+
+    for (int32_t testCase = 0; testCase < TEST_LAYOUT_CASE_COUNT; ++testCase) {
+        Test_CompareLayouts(testCase, Test_DeclareNestedLayout);
+    }
+    for (int32_t testCase = 0; testCase < TEST_LARGE_CASE_COUNT; ++testCase) {
+        Test_CompareLayouts(testCase, Test_DeclareLargeLayout);
+    }
+
+    if (Test_FailureCount > 0) {
+        fprintf(stderr, "%d checks failed\n", Test_FailureCount);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Regression tests for the text measurement cache. Exits with a non zero status if any check fails.
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_TEXT_COUNT 512
+
+int32_t Test_FailureCount = 0;
+int32_t Test_MeasureTextCallCount = 0;
+char Test_TextStorage[TEST_TEXT_COUNT][8];
+
+#define TEST_CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Test_FailureCount++; } } while (0)
+
+Clay_Dimensions Test_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    Test_MeasureTextCallCount++;
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.5f, .height = (float)config->fontSize };
+}
+
+void Test_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    Test_FailureCount++;
+}
+
+void Test_DeclareTextLayout(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Container"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .layoutDirection = CLAY_TOP_TO_BOTTOM } }) {
+        for (int32_t i = 0; i < TEST_TEXT_COUNT; ++i) {
+            Clay_String text = { .length = 7, .chars = Test_TextStorage[i] };
+            CLAY_TEXT(text, CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+        }
+    }
+    Clay_EndLayout(0);
+}
+
+// Raising the word count after initialization, as the examples do from their error handlers, must keep using
+// the buckets that were allocated at initialization
+void Test_RaisedMaxWordCount(void) {
+    Clay_SetMaxMeasureTextCacheWordCount(Clay_GetMaxMeasureTextCacheWordCount() * 4);
+
+    Test_DeclareTextLayout();
+
+    // Every word is cached, so nothing is measured again
+    Test_MeasureTextCallCount = 0;
+    Test_DeclareTextLayout();
+    TEST_CHECK(Test_MeasureTextCallCount == 0);
+
+    Clay_MemoryStats stats = Clay_GetMemoryStats();
+    TEST_CHECK(stats.measureTextHashMap.bucketCount == stats.arrays[CLAY_MEMORY_ARRAY_MEASURE_TEXT_CACHE_BUCKETS].capacity);
+    TEST_CHECK(stats.measureTextHashMap.itemCount == TEST_TEXT_COUNT);
+}
+
+int main(void) {
+    for (int32_t i = 0; i < TEST_TEXT_COUNT; ++i) {
+        snprintf(Test_TextStorage[i], sizeof(Test_TextStorage[i]), "w%06d", (int)i);
+    }
+
+    uint32_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 800, 600 }, (Clay_ErrorHandler) { Test_HandleError });
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+
+    Test_RaisedMaxWordCount();
+
+    if (Test_FailureCount > 0) {
+        fprintf(stderr, "%d checks failed\n", Test_FailureCount);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}
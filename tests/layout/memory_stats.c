@@ -0,0 +1,97 @@
+// Regression tests for the array lengths reported by Clay_GetMemoryStats. Exits with a non zero status if any check fails.
+
+// Must be defined in one file, _before_ #include "clay.h"
+#define CLAY_IMPLEMENTATION
+#include "../../clay.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_NESTING_DEPTH 40
+#define TEST_SIBLING_COUNT 300
+
+int32_t Test_FailureCount = 0;
+
+#define TEST_CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); Test_FailureCount++; } } while (0)
+
+Clay_Dimensions Test_MeasureText(Clay_StringSlice text, Clay_TextElementConfig *config, void *userData) {
+    return (Clay_Dimensions) { .width = (float)text.length * (float)config->fontSize * 0.5f, .height = (float)config->fontSize };
+}
+
+void Test_HandleError(Clay_ErrorData errorData) {
+    fprintf(stderr, "clay error: %.*s\n", errorData.errorText.length, errorData.errorText.chars);
+    Test_FailureCount++;
+}
+
+// A chain of nested clip containers, TEST_NESTING_DEPTH deep, with a row of TEST_SIBLING_COUNT GROW siblings at the bottom
+void Test_DeclareNestedClipContainers(int32_t depth) {
+    CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) }, .padding = CLAY_PADDING_ALL(1) }, .clip = { .vertical = true } }) {
+        if (depth < TEST_NESTING_DEPTH) {
+            Test_DeclareNestedClipContainers(depth + 1);
+        } else {
+            for (int32_t i = 0; i < TEST_SIBLING_COUNT; ++i) {
+                CLAY_AUTO_ID({ .layout = { .sizing = { CLAY_SIZING_GROW((float)(i % 7)), CLAY_SIZING_FIXED(10) } } }) {}
+            }
+        }
+    }
+}
+
+void Test_DeclareSmallLayout(void) {
+    Clay_BeginLayout();
+    CLAY(CLAY_ID("Container"), { .layout = { .sizing = { CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0) } } }) {
+        CLAY_TEXT(CLAY_STRING("Small"), CLAY_TEXT_CONFIG({ .fontSize = 16 }));
+    }
+    Clay_EndLayout(0);
+}
+
+// Scratch arrays are empty again by the end of Clay_EndLayout, so their lengths must come from where they held the most items
+void Test_ScratchArrayLengths(void) {
+    Clay_BeginLayout();
+    Test_DeclareNestedClipContainers(1);
+    Clay_EndLayout(0);
+
+    Clay_MemoryStats stats = Clay_GetMemoryStats();
+    // The root container, every level of the chain and one of the siblings are open at once
+    TEST_CHECK(stats.arrays[CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK].length >= TEST_NESTING_DEPTH + 2);
+    TEST_CHECK(stats.arrays[CLAY_MEMORY_ARRAY_OPEN_CLIP_ELEMENT_STACK].length >= TEST_NESTING_DEPTH);
+    // The siblings are all waiting in the children buffer when the bottom of the chain closes
+    TEST_CHECK(stats.arrays[CLAY_MEMORY_ARRAY_LAYOUT_ELEMENT_CHILDREN_BUFFER].length >= TEST_SIBLING_COUNT);
+    TEST_CHECK(stats.arrays[CLAY_MEMORY_ARRAY_LAYOUT_TREE_NODES].length >= TEST_SIBLING_COUNT);
+    // Growing the siblings distributes space between all of them along the x axis
+    TEST_CHECK(stats.arrays[CLAY_MEMORY_ARRAY_DISTRIBUTION_KEYS].length >= TEST_SIBLING_COUNT * 3);
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        TEST_CHECK(stats.arrays[i].length <= stats.arrays[i].capacity);
+        TEST_CHECK(stats.arrays[i].peakLength >= stats.arrays[i].length);
+    }
+
+    // A smaller layout reports shorter lengths but keeps the peaks
+    Test_DeclareSmallLayout();
+    Clay_MemoryStats smallStats = Clay_GetMemoryStats();
+    TEST_CHECK(smallStats.arrays[CLAY_MEMORY_ARRAY_OPEN_LAYOUT_ELEMENT_STACK].length < TEST_NESTING_DEPTH);
+    TEST_CHECK(smallStats.arrays[CLAY_MEMORY_ARRAY_DISTRIBUTION_KEYS].length < TEST_SIBLING_COUNT);
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        TEST_CHECK(smallStats.arrays[i].peakLength >= stats.arrays[i].length);
+    }
+
+    Clay_ResetMemoryStats();
+    Clay_MemoryStats resetStats = Clay_GetMemoryStats();
+    for (int32_t i = 0; i < CLAY_MEMORY_ARRAY_COUNT; ++i) {
+        TEST_CHECK(resetStats.arrays[i].peakLength == smallStats.arrays[i].length);
+    }
+}
+
+int main(void) {
+    uint32_t totalMemorySize = Clay_MinMemorySize();
+    Clay_Arena arena = Clay_CreateArenaWithCapacityAndMemory(totalMemorySize, malloc(totalMemorySize));
+    Clay_Initialize(arena, (Clay_Dimensions) { 1000, 600 }, (Clay_ErrorHandler) { Test_HandleError });
+    Clay_SetMeasureTextFunction(Test_MeasureText, NULL);
+
+    Test_ScratchArrayLengths();
+
+    if (Test_FailureCount > 0) {
+        fprintf(stderr, "%d checks failed\n", Test_FailureCount);
+        return 1;
+    }
+    printf("All checks passed\n");
+    return 0;
+}